@@ -0,0 +1,11 @@
+#pragma once
+#include "../ntshengn_ecs_entity.h"
+
+namespace NtshEngn {
+
+	// The Transform of an Entity having a Parent is relative to the Transform of its parent Entity
+	struct Parent {
+		Entity entity = NTSHENGN_ENTITY_UNKNOWN;
+	};
+
+}
\ No newline at end of file
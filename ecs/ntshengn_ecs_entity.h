@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+namespace NtshEngn {
+
+	// An Entity is an index (low bits) and a generation (high bits)
+	// The generation of an index is incremented each time its Entity is destroyed, so that stale Entities do not alias new ones
+	typedef uint32_t Entity;
+	#define NTSHENGN_ENTITY_UNKNOWN 0xFFFFFFFF
+
+	#define NTSHENGN_ENTITY_INDEX_BITS 20
+	#define NTSHENGN_ENTITY_INDEX_MASK 0xFFFFF
+	#define NTSHENGN_ENTITY_GENERATION_MASK 0xFFF
+	#define NTSHENGN_ENTITY_GENERATION_DEFERRED 0xFFF // Never given to an Entity, marks Entities created in an ECSCommandBuffer
+
+	inline uint32_t getEntityIndex(Entity entity) {
+		return entity & NTSHENGN_ENTITY_INDEX_MASK;
+	}
+
+	inline uint32_t getEntityGeneration(Entity entity) {
+		return (entity >> NTSHENGN_ENTITY_INDEX_BITS) & NTSHENGN_ENTITY_GENERATION_MASK;
+	}
+
+	inline Entity makeEntity(uint32_t index, uint32_t generation) {
+		return (generation << NTSHENGN_ENTITY_INDEX_BITS) | index;
+	}
+
+}
\ No newline at end of file
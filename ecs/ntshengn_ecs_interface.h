@@ -1,7 +1,11 @@
 #pragma once
 #include "../utils/ntshengn_defines.h"
-#include "../utils/ntshengn_utils_bimap.h"
+#include "../utils/ntshengn_utils_buffer.h"
+#include "../job_system/ntshengn_job_system_interface.h"
+#include "../profiler/ntshengn_profiler_interface.h"
+#include "ntshengn_ecs_entity.h"
 #include "components/ntshengn_ecs_transform.h"
+#include "components/ntshengn_ecs_parent.h"
 #include "components/ntshengn_ecs_renderable.h"
 #include "components/ntshengn_ecs_camera.h"
 #include "components/ntshengn_ecs_light.h"
@@ -15,477 +19,2962 @@
 #include <array>
 #include <unordered_map>
 #include <memory>
-#include <set>
 #include <string>
+#include <string_view>
 #include <algorithm>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <functional>
+#if defined(NTSHENGN_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+#if !defined(NTSHENGN_COMPILER_MSVC) && __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <cstdlib>
+#define NTSHENGN_ECS_DEMANGLE
+#endif
 
-#define NTSHENGN_MAX_ENTITIES 4096
 #define NTSHENGN_MAX_COMPONENTS 32
 
+#define NTSHENGN_COMPONENT_PAGE_SIZE 1024
+
+#define NTSHENGN_COMPONENT_INDEX_UNKNOWN 0xFFFFFFFF
+
+#define NTSHENGN_TYPE_ID_UNKNOWN 0xFFFFFFFF
+
+#define NTSHENGN_COMMAND_BUFFER_BLOCK_SIZE 65536
+
+#define NTSHENGN_ARCHETYPE_CHUNK_SIZE 16384
+#define NTSHENGN_ARCHETYPE_CHUNK_ALIGNMENT 64
+#define NTSHENGN_ARCHETYPE_UNKNOWN 0xFFFFFFFF
+
+#define NTSHENGN_ECS_SNAPSHOT_MAGIC 0x4E534345
+#define NTSHENGN_ECS_SNAPSHOT_VERSION 2
+
 namespace NtshEngn {
 
-	typedef uint32_t Entity;
-	#define NTSHENGN_ENTITY_UNKNOWN 0xFFFFFFFF
+	// Snapshots are raw memory copies, they can only be read by the same build on the same platform
+	template <typename T>
+	inline void writeSnapshotValues(Buffer& snapshot, const T* values, size_t count) {
+		snapshot.write(reinterpret_cast<const std::byte*>(values), sizeof(T) * count);
+	}
 
-	typedef uint8_t Component;
-	typedef std::bitset<NTSHENGN_MAX_COMPONENTS> ComponentMask;
+	template <typename T>
+	inline void readSnapshotValues(Buffer& snapshot, T* values, size_t count) {
+		const size_t size = sizeof(T) * count;
+		const size_t readSize = (size != 0) ? snapshot.read(reinterpret_cast<std::byte*>(values), size) : 0;
 
-	class EntityManager {
-	public:
-		EntityManager() {
-			for (Entity entity = 0; entity < NTSHENGN_MAX_ENTITIES; entity++) {
-				m_availableEntities.push_back(entity);
-			}
-		}
+		NTSHENGN_ASSERT(readSize == size, "Snapshot is truncated.");
+		NTSHENGN_UNUSED(readSize);
+	}
 
-		Entity createEntity() {
-			NTSHENGN_ASSERT(m_numberOfEntities < NTSHENGN_MAX_ENTITIES, "Too many Entities.");
+	template <typename T>
+	inline void writeSnapshotValue(Buffer& snapshot, const T& value) {
+		writeSnapshotValues(snapshot, &value, 1);
+	}
 
-			Entity id = m_availableEntities.front();
-			m_availableEntities.pop_front();
-			m_numberOfEntities++;
+	template <typename T>
+	inline T readSnapshotValue(Buffer& snapshot) {
+		T value;
+		readSnapshotValues(snapshot, &value, 1);
 
-			m_existingEntities.insert(id);
+		return value;
+	}
 
-			return id;
-		}
+	inline void writeSnapshotString(Buffer& snapshot, std::string_view string) {
+		writeSnapshotValue(snapshot, static_cast<uint32_t>(string.size()));
+		writeSnapshotValues(snapshot, string.data(), string.size());
+	}
 
-		Entity createEntity(const std::string& name) {
-			NTSHENGN_ASSERT(!m_entityNames.contains(name), "An Entity named \"" + name + "\" already exists.");
+	inline std::string readSnapshotString(Buffer& snapshot) {
+		std::string string(readSnapshotValue<uint32_t>(snapshot), '\0');
+		readSnapshotValues(snapshot, string.data(), string.size());
 
-			Entity id = createEntity();
-			m_entityNames.insert_or_assign(id, name);
+		return string;
+	}
 
-			return id;
-		}
+	// Components saved in ECS snapshots, which are raw memory copies
+	// Components opt in by specializing SnapshotComponent as std::true_type, they must be trivially copyable and must not hold pointers or resource handles, which do not survive a load
+	template <typename T>
+	struct SnapshotComponent : std::false_type {};
 
-		void destroyEntity(Entity entity) {
-			NTSHENGN_ASSERT(m_existingEntities.find(entity) != m_existingEntities.end(), "Entity " + std::to_string(entity) + " does not exist.");
+	template <>
+	struct SnapshotComponent<Transform> : std::true_type {};
 
-			m_componentMasks[entity].reset();
-			m_availableEntities.push_front(entity);
-			m_numberOfEntities--;
+	template <>
+	struct SnapshotComponent<Parent> : std::true_type {};
 
-			m_existingEntities.erase(entity);
+	template <>
+	struct SnapshotComponent<Camera> : std::true_type {};
 
-			if (m_entityNames.contains(entity)) {
-				m_entityNames.erase(entity);
-			}
+	template <>
+	struct SnapshotComponent<Light> : std::true_type {};
 
-			if (m_persistentEntities.find(entity) != m_persistentEntities.end()) {
-				m_persistentEntities.erase(entity);
-			}
+	template <>
+	struct SnapshotComponent<Rigidbody> : std::true_type {};
 
-			if (m_entityGroupsOfEntities.find(entity) != m_entityGroupsOfEntities.end()) {
-				const std::set<std::string>& entityGroupNames = m_entityGroupsOfEntities[entity];
-				for (const std::string& entityGroupName : entityGroupNames) {
-					m_entityGroups[entityGroupName].erase(entity);
+	template <>
+	struct SnapshotComponent<SoundListener> : std::true_type {};
 
-					if (m_entityGroups[entityGroupName].empty()) {
-						m_entityGroups.erase(entityGroupName);
-					}
-				}
+	// A NameID identifies an interned Entity name, it stays valid as long as an Entity has the name
+	// Names are released when their Entity is destroyed or renamed, and their NameIDs are reused for new names
+	typedef uint32_t NameID;
+	#define NTSHENGN_NAME_UNKNOWN 0xFFFFFFFF
+
+	// An EntityGroupID identifies an Entity group, it stays valid as long as the Entity group has Entities
+	// Empty Entity groups are released, and their EntityGroupIDs are reused for new Entity groups
+	typedef uint32_t EntityGroupID;
+	#define NTSHENGN_ENTITY_GROUP_UNKNOWN 0xFFFFFFFF
+
+	typedef uint8_t Component;
+	typedef std::bitset<NTSHENGN_MAX_COMPONENTS> ComponentMask;
 
-				m_entityGroupsOfEntities.erase(entity);
+	// Set of Entities backed by a bitset over Entity indices, iterated in index order
+	// contains is a single compare, and erasing the current Entity while iterating is allowed
+	// A set created with the generations of an EntityManager only stores its bitset, and must only contain existing Entities
+	class EntitySet {
+	public:
+		class Iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Entity value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const Entity* pointer;
+			typedef Entity reference;
+
+			Iterator(const EntitySet* entitySet, uint32_t index) : m_entitySet(entitySet), m_index(index) {}
+
+			Entity operator*() const {
+				return m_entitySet->getEntity(m_index);
 			}
-		}
 
-		void setComponents(Entity entity, ComponentMask componentMask) {
-			NTSHENGN_ASSERT(entity < NTSHENGN_MAX_ENTITIES, "Entity " + std::to_string(entity) + " does not exist.");
+			Iterator& operator++() {
+				m_index = m_entitySet->findNextIndex(m_index + 1);
 
-			m_componentMasks[entity] = componentMask;
-		}
+				return *this;
+			}
 
-		ComponentMask getComponents(Entity entity) {
-			NTSHENGN_ASSERT(entity < NTSHENGN_MAX_ENTITIES, "Entity " + std::to_string(entity) + " does not exist.");
+			bool operator==(const Iterator& other) const {
+				return m_index == other.m_index;
+			}
 
-			return m_componentMasks[entity];
-		}
+			bool operator!=(const Iterator& other) const {
+				return m_index != other.m_index;
+			}
 
-		bool entityExists(Entity entity) {
-			return m_existingEntities.find(entity) != m_existingEntities.end();
+		private:
+			const EntitySet* m_entitySet;
+			uint32_t m_index;
+		};
+
+	public:
+		EntitySet() = default;
+		explicit EntitySet(const std::vector<uint32_t>* generations) : m_generations(generations) {}
+		// Copies store their Entities, as the generations of the EntityManager change when Entities are destroyed
+		EntitySet(const EntitySet& other) : m_words(other.m_words), m_entities(other.m_entities), m_size(other.m_size) {
+			if (other.m_generations) {
+				m_entities.assign(m_words.size() * 64, NTSHENGN_ENTITY_UNKNOWN);
+				for (Entity entity : other) {
+					m_entities[getEntityIndex(entity)] = entity;
+				}
+			}
 		}
+		EntitySet(EntitySet&&) = default;
+		EntitySet& operator=(const EntitySet& other) {
+			if (this != &other) {
+				*this = EntitySet(other);
+			}
 
-		const std::set<Entity>& getExistingEntities() {
-			return m_existingEntities;
+			return *this;
 		}
+		EntitySet& operator=(EntitySet&&) = default;
 
-		void setEntityName(Entity entity, const std::string& name) {
-			NTSHENGN_ASSERT(!m_entityNames.contains(name), "An Entity named \"" + name + "\" already exists.");
+		bool insert(Entity entity) {
+			const uint32_t index = getEntityIndex(entity);
+			if (m_generations) {
+				if (index >= getIndexCount()) {
+					m_words.resize((index / 64) + 1, 0);
+				}
 
-			m_entityNames.insert_or_assign(entity, name);
-		}
+				// The Entity at an index of the set is always the existing one
+				if (m_words[index / 64] & (1ULL << (index % 64))) {
+					return false;
+				}
 
-		bool entityHasName(Entity entity) {
-			return m_entityNames.contains(entity);
-		}
+				m_words[index / 64] |= (1ULL << (index % 64));
+				m_size++;
 
-		std::string getEntityName(Entity entity) {
-			if (m_entityNames.contains(entity)) {
-				return m_entityNames[entity];
+				return true;
 			}
-			else {
-				return "";
+
+			if (index >= m_entities.size()) {
+				m_entities.resize(index + 1, NTSHENGN_ENTITY_UNKNOWN);
+				m_words.resize((m_entities.size() + 63) / 64, 0);
 			}
-		}
 
-		Entity findEntityByName(const std::string& name) {
-			if (m_entityNames.contains(name)) {
-				return m_entityNames[name];
+			if (m_entities[index] == entity) {
+				return false;
 			}
-			else {
-				return NTSHENGN_ENTITY_UNKNOWN;
+
+			if (m_entities[index] == NTSHENGN_ENTITY_UNKNOWN) {
+				m_words[index / 64] |= (1ULL << (index % 64));
+				m_size++;
 			}
+			m_entities[index] = entity;
+
+			return true;
 		}
 
-		void setEntityPersistence(Entity entity, bool persistent) {
-			if (persistent) {
-				m_persistentEntities.insert(entity);
+		size_t erase(Entity entity) {
+			if (!contains(entity)) {
+				return 0;
 			}
-			else {
-				if (m_persistentEntities.find(entity) != m_persistentEntities.end()) {
-					m_persistentEntities.erase(entity);
-				}
+
+			const uint32_t index = getEntityIndex(entity);
+			m_words[index / 64] &= ~(1ULL << (index % 64));
+			if (!m_generations) {
+				m_entities[index] = NTSHENGN_ENTITY_UNKNOWN;
 			}
+			m_size--;
+
+			return 1;
 		}
 
-		bool isEntityPersistent(Entity entity) {
-			return m_persistentEntities.find(entity) != m_persistentEntities.end();
+		void clear() {
+			m_words.clear();
+			m_entities.clear();
+			m_size = 0;
 		}
 
-		const std::set<Entity>& getPersistentEntities() {
-			return m_persistentEntities;
+		bool contains(Entity entity) const {
+			const uint32_t index = getEntityIndex(entity);
+			if (m_generations) {
+				return (index < getIndexCount()) && (m_words[index / 64] & (1ULL << (index % 64))) && ((*m_generations)[index] == getEntityGeneration(entity));
+			}
+
+			return (index < m_entities.size()) && (m_entities[index] == entity);
 		}
 
-		void addEntityToEntityGroup(Entity entity, const std::string& entityGroupName) {
-			m_entityGroups[entityGroupName].insert(entity);
-			m_entityGroupsOfEntities[entity].insert(entityGroupName);
+		size_t count(Entity entity) const {
+			return contains(entity) ? 1 : 0;
 		}
 
-		void removeEntityFromEntityGroup(Entity entity, const std::string& entityGroupName) {
-			if (m_entityGroups.find(entityGroupName) != m_entityGroups.end()) {
-				m_entityGroups[entityGroupName].erase(entity);
+		Iterator find(Entity entity) const {
+			return contains(entity) ? Iterator(this, getEntityIndex(entity)) : end();
+		}
 
-				if (m_entityGroups[entityGroupName].empty()) {
-					m_entityGroups.erase(entityGroupName);
-				}
-			}
+		size_t size() const {
+			return m_size;
+		}
 
-			if (m_entityGroupsOfEntities.find(entity) != m_entityGroupsOfEntities.end()) {
-				m_entityGroupsOfEntities[entity].erase(entityGroupName);
-			}
+		bool empty() const {
+			return m_size == 0;
 		}
 
-		bool entityGroupExists(const std::string& entityGroupName) {
-			return m_entityGroups.find(entityGroupName) != m_entityGroups.end();
+		// Allocated bytes
+		size_t getMemorySize() const {
+			return (m_words.capacity() * sizeof(uint64_t)) + (m_entities.capacity() * sizeof(Entity));
 		}
 
-		bool isEntityInEntityGroup(Entity entity, const std::string& entityGroupName) {
-			if (m_entityGroupsOfEntities.find(entity) != m_entityGroupsOfEntities.end()) {
-				return m_entityGroupsOfEntities[entity].find(entityGroupName) != m_entityGroupsOfEntities[entity].end();
-			}
+		Iterator begin() const {
+			return Iterator(this, findNextIndex(0));
+		}
 
-			return false;
+		Iterator end() const {
+			return Iterator(this, getIndexCount());
 		}
 
-		std::set<Entity> getEntitiesInEntityGroup(const std::string& entityGroupName) {
-			if (m_entityGroups.find(entityGroupName) != m_entityGroups.end()) {
-				return m_entityGroups[entityGroupName];
+		// Entities in both sets, computed 64 indices at a time
+		EntitySet getIntersection(const EntitySet& other) const {
+			EntitySet intersection;
+			const size_t wordCount = std::min(m_words.size(), other.m_words.size());
+			intersection.m_words.resize(wordCount);
+			intersection.m_entities.resize(std::min(getIndexCount(), other.getIndexCount()), NTSHENGN_ENTITY_UNKNOWN);
+			for (size_t wordIndex = 0; wordIndex < wordCount; wordIndex++) {
+				uint64_t word = m_words[wordIndex] & other.m_words[wordIndex];
+				uint64_t remainingWord = word;
+				while (remainingWord != 0) {
+					const uint32_t index = static_cast<uint32_t>((wordIndex * 64) + countTrailingZeros(remainingWord));
+					remainingWord &= remainingWord - 1;
+					const Entity entity = getEntity(index);
+					if (entity == other.getEntity(index)) {
+						intersection.m_entities[index] = entity;
+						intersection.m_size++;
+					}
+					else {
+						word &= ~(1ULL << (index % 64));
+					}
+				}
+				intersection.m_words[wordIndex] = word;
 			}
 
-			return std::set<Entity>();
+			return intersection;
 		}
 
-		std::set<std::string> getEntityGroupsOfEntity(Entity entity) {
-			if (m_entityGroupsOfEntities.find(entity) != m_entityGroupsOfEntities.end()) {
-				return m_entityGroupsOfEntities[entity];
+		// Entities in any of the sets, computed 64 indices at a time
+		EntitySet getUnion(const EntitySet& other) const {
+			const EntitySet& larger = (getIndexCount() >= other.getIndexCount()) ? *this : other;
+			const EntitySet& smaller = (getIndexCount() >= other.getIndexCount()) ? other : *this;
+
+			EntitySet entitySetUnion = larger;
+			for (size_t wordIndex = 0; wordIndex < smaller.m_words.size(); wordIndex++) {
+				uint64_t addedWord = smaller.m_words[wordIndex] & ~larger.m_words[wordIndex];
+				entitySetUnion.m_words[wordIndex] |= addedWord;
+				while (addedWord != 0) {
+					const uint32_t index = static_cast<uint32_t>((wordIndex * 64) + countTrailingZeros(addedWord));
+					addedWord &= addedWord - 1;
+					entitySetUnion.m_entities[index] = smaller.getEntity(index);
+					entitySetUnion.m_size++;
+				}
 			}
 
-			return std::set<std::string>();
+			return entitySetUnion;
 		}
 
 	private:
-		std::deque<Entity> m_availableEntities;
-		std::set<Entity> m_existingEntities;
-		std::array<ComponentMask, NTSHENGN_MAX_ENTITIES> m_componentMasks;
-		Bimap<Entity, std::string> m_entityNames;
-		std::set<Entity> m_persistentEntities;
-		std::unordered_map<std::string, std::set<Entity>> m_entityGroups;
-		std::unordered_map<Entity, std::set<std::string>> m_entityGroupsOfEntities;
-		uint32_t m_numberOfEntities = 0;
-	};
-
-	class ComponentArrayInterface {
-	public:
-		virtual ~ComponentArrayInterface() = default;
-		virtual void entityDestroyed(Entity entity) = 0;
-	};
-
-	template <typename T>
-	class ComponentArray : public ComponentArrayInterface {
-	public:
-		void insertData(Entity entity, T component) {
-			NTSHENGN_ASSERT(m_entityToIndex.find(entity) == m_entityToIndex.end(), "Entity " + std::to_string(entity) + " already has this component.");
-
-			m_entityToIndex[entity] = m_validSize;
-			m_indexToEntity[m_validSize] = entity;
-			m_components[m_validSize] = component;
-			m_validSize++;
+		uint32_t getIndexCount() const {
+			return static_cast<uint32_t>(m_generations ? (m_words.size() * 64) : m_entities.size());
 		}
 
-		void removeData(Entity entity) {
-			NTSHENGN_ASSERT(m_entityToIndex.find(entity) != m_entityToIndex.end(), "Entity " + std::to_string(entity) + " does not have this component.");
-
-			size_t tmp = m_entityToIndex[entity];
-			m_components[tmp] = m_components[m_validSize - 1];
-			Entity entityLast = m_indexToEntity[m_validSize - 1];
-			m_entityToIndex[entityLast] = tmp;
-			m_indexToEntity[tmp] = entityLast;
-			m_entityToIndex.erase(entity);
-			m_indexToEntity.erase(m_validSize - 1);
-			m_validSize--;
+		Entity getEntity(uint32_t index) const {
+			return m_generations ? makeEntity(index, (*m_generations)[index]) : m_entities[index];
 		}
 
-		bool hasComponent(Entity entity) {
-			return m_entityToIndex.find(entity) != m_entityToIndex.end();
-		}
+		uint32_t findNextIndex(uint32_t index) const {
+			size_t wordIndex = index / 64;
+			if (wordIndex >= m_words.size()) {
+				return getIndexCount();
+			}
 
-		T& getData(Entity entity) {
-			NTSHENGN_ASSERT(m_entityToIndex.find(entity) != m_entityToIndex.end(), "Entity " + std::to_string(entity) + " does not have this component.");
+			uint64_t word = m_words[wordIndex] & (~0ULL << (index % 64));
+			while (word == 0) {
+				wordIndex++;
+				if (wordIndex == m_words.size()) {
+					return getIndexCount();
+				}
+				word = m_words[wordIndex];
+			}
 
-			return m_components[m_entityToIndex[entity]];
+			return static_cast<uint32_t>((wordIndex * 64) + countTrailingZeros(word));
 		}
 
-		void entityDestroyed(Entity entity) override {
-			if (m_entityToIndex.find(entity) != m_entityToIndex.end()) {
-				removeData(entity);
+		static uint32_t countTrailingZeros(uint64_t word) {
+#if defined(NTSHENGN_COMPILER_MSVC)
+			unsigned long index;
+			_BitScanForward64(&index, word);
+
+			return static_cast<uint32_t>(index);
+#elif defined(NTSHENGN_COMPILER_GCC) || defined(NTSHENGN_COMPILER_CLANG)
+			return static_cast<uint32_t>(__builtin_ctzll(word));
+#else
+			uint32_t index = 0;
+			while ((word & 1) == 0) {
+				word >>= 1;
+				index++;
 			}
+
+			return index;
+#endif
 		}
 
 	private:
-		std::array<T, NTSHENGN_MAX_ENTITIES> m_components;
-		std::unordered_map<Entity, size_t> m_entityToIndex;
-		std::unordered_map<size_t, Entity> m_indexToEntity;
-		size_t m_validSize;
+		std::vector<uint64_t> m_words;
+		std::vector<Entity> m_entities; // Entity at each index, NTSHENGN_ENTITY_UNKNOWN if the index is not in the set, empty with m_generations
+		size_t m_size = 0;
+		const std::vector<uint32_t>* m_generations = nullptr; // Generation of each Entity index, owned by the EntityManager
 	};
 
-	class ComponentManager {
+	// IDs given to types (Components, Systems) when they are registered
+	// The IDs are keyed by type name at registration so that every module (shared library) agrees on them
+	// Each binary then caches the ID of a type after its first lookup, tagged with the registry's serial, so that lookups are a single atomic load
+	class TypeIDRegistry {
 	public:
+		TypeIDRegistry() : m_serial(nextSerial()) {}
+
 		template <typename T>
-		void registerComponent() {
-			std::string typeName = std::string(typeid(T).name());
+		uint32_t registerType() {
+			const std::string typeName = std::string(typeid(T).name());
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) == m_componentTypes.end(), "Component is already registered.");
+			NTSHENGN_ASSERT(m_typeIDs.find(typeName) == m_typeIDs.end(), "Type is already registered.");
 
-			m_componentTypes.insert({ typeName, m_nextComponent });
-			m_componentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
-			m_nextComponent++;
+			const uint32_t typeID = static_cast<uint32_t>(m_typeIDs.size());
+			m_typeIDs.insert({ typeName, typeID });
+			m_displayNames.push_back(demangle(typeid(T).name()));
+			cache<T>().store((static_cast<uint64_t>(m_serial) << 32) | typeID, std::memory_order_relaxed);
+
+			return typeID;
 		}
 
+		// Returns NTSHENGN_TYPE_ID_UNKNOWN if the type is not registered
 		template <typename T>
-		Component getComponentID() {
-			std::string typeName = std::string(typeid(T).name());
+		uint32_t getID() const {
+			const uint64_t cachedTypeID = cache<T>().load(std::memory_order_relaxed);
+			if (static_cast<uint32_t>(cachedTypeID >> 32) == m_serial) {
+				return static_cast<uint32_t>(cachedTypeID);
+			}
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) != m_componentTypes.end(), "Component is not registered.");
+			std::unordered_map<std::string, uint32_t>::const_iterator it = m_typeIDs.find(std::string(typeid(T).name()));
+			if (it == m_typeIDs.end()) {
+				return NTSHENGN_TYPE_ID_UNKNOWN;
+			}
+			cache<T>().store((static_cast<uint64_t>(m_serial) << 32) | it->second, std::memory_order_relaxed);
 
-			return m_componentTypes[typeName];
+			return it->second;
 		}
 
-		template <typename T>
-		void addComponent(Entity entity, T component) {
-			getComponentArray<T>()->insertData(entity, component);
-		}
+		// Returns NTSHENGN_TYPE_ID_UNKNOWN if the type is not registered
+		uint32_t getID(const std::string& typeName) const {
+			std::unordered_map<std::string, uint32_t>::const_iterator it = m_typeIDs.find(typeName);
+			if (it == m_typeIDs.end()) {
+				return NTSHENGN_TYPE_ID_UNKNOWN;
+			}
 
-		template <typename T>
-		void removeComponent(Entity entity) {
-			getComponentArray<T>()->removeData(entity);
+			return it->second;
 		}
 
-		template <typename T>
-		bool hasComponent(Entity entity) {
-			return getComponentArray<T>()->hasComponent(entity);
-		}
+		// Readable type name, for logs and statistics, empty if no type has this ID
+		const std::string& getDisplayName(uint32_t typeID) const {
+			static const std::string noName;
+			if (typeID >= m_displayNames.size()) {
+				return noName;
+			}
 
-		template <typename T>
-		T& getComponent(Entity entity) {
-			return getComponentArray<T>()->getData(entity);
+			return m_displayNames[typeID];
 		}
 
-		void entityDestroyed(Entity entity) {
-			for (const auto& pair : m_componentArrays) {
-				const std::shared_ptr<ComponentArrayInterface>& componentArray = pair.second;
-				componentArray->entityDestroyed(entity);
+		// Returns an empty string if no type has this ID
+		std::string getName(uint32_t typeID) const {
+			for (const std::pair<const std::string, uint32_t>& typeIDPair : m_typeIDs) {
+				if (typeIDPair.second == typeID) {
+					return typeIDPair.first;
+				}
 			}
+
+			return "";
+		}
+
+		size_t size() const {
+			return m_typeIDs.size();
 		}
 
 	private:
-		std::unordered_map<std::string, Component> m_componentTypes;
-		std::unordered_map<std::string, std::shared_ptr<ComponentArrayInterface>> m_componentArrays;
-		Component m_nextComponent = 0;
+		// Demangles type names on Itanium ABI compilers, and removes the "struct " and "class " prefixes of MSVC
+		static std::string demangle(const char* typeName) {
+#if defined(NTSHENGN_ECS_DEMANGLE)
+			int status = 0;
+			char* demangledTypeName = abi::__cxa_demangle(typeName, nullptr, nullptr, &status);
+			if ((status == 0) && demangledTypeName) {
+				const std::string displayName = demangledTypeName;
+				std::free(demangledTypeName);
+
+				return displayName;
+			}
+
+			return typeName;
+#else
+			std::string displayName = typeName;
+			for (std::string_view prefix : { std::string_view("struct "), std::string_view("class ") }) {
+				size_t position;
+				while ((position = displayName.find(prefix)) != std::string::npos) {
+					displayName.erase(position, prefix.size());
+				}
+			}
+
+			return displayName;
+#endif
+		}
 
 		template <typename T>
-		std::shared_ptr<ComponentArray<T>> getComponentArray() {
-			std::string typeName = std::string(typeid(T).name());
+		static std::atomic<uint64_t>& cache() {
+			static std::atomic<uint64_t> cachedTypeID = 0;
 
-			NTSHENGN_ASSERT(m_componentTypes.find(typeName) != m_componentTypes.end(), "Component does not exist.");
+			return cachedTypeID;
+		}
+
+		static uint32_t nextSerial() {
+			static std::atomic<uint32_t> serial = 1;
 
-			return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays[typeName]);
+			return serial++;
 		}
+
+	private:
+		const uint32_t m_serial;
+		std::unordered_map<std::string, uint32_t> m_typeIDs;
+		std::vector<std::string> m_displayNames; // Indexed by type ID
 	};
 
-	class System {
-	public:
-		virtual void onEntityComponentAdded(Entity entity, Component componentID) { NTSHENGN_UNUSED(entity); NTSHENGN_UNUSED(componentID); }
-		virtual void onEntityComponentRemoved(Entity entity, Component componentID) { NTSHENGN_UNUSED(entity); NTSHENGN_UNUSED(componentID); }
-		
-	public:
-		std::set<Entity> entities;
+	// Memory and occupancy of the ECS, returned by ECSInterface::getStatistics
+	// Sizes are in bytes and do not include the overhead of hash maps
+	struct ComponentStatistics {
+		std::string name = "";
+		Component componentID = 0;
+		size_t count = 0;
+		size_t capacity = 0; // Components fitting in the allocated storage
+		size_t bytes = 0;
+		double fragmentation = 0.0; // Unused fraction of the capacity
 	};
 
-	class SystemManager {
-	public:
-		template <typename T>
-		void registerSystem(System* system) {
-			std::string typeName = std::string(typeid(T).name());
+	struct SystemStatistics {
+		std::string name = "";
+		size_t entityCount = 0;
+	};
 
-			NTSHENGN_ASSERT(m_systems.find(typeName) == m_systems.end(), "System is already registered.");
+	struct ECSStatistics {
+		size_t entityCount = 0;
+		size_t entityIndexCount = 0; // Entity indices allocated so far, including the available ones
+		size_t availableEntityIndexCount = 0;
+		size_t maxEntities = 0;
+		size_t entityBytes = 0;
 
-			m_systems.insert({ typeName, system });
-		}
+		// Only with ComponentStorageType::Archetype, archetypeBytes includes the Entity columns and alignment padding
+		size_t archetypeCount = 0;
+		size_t archetypeBytes = 0;
 
-		template <typename T>
-		void setComponents(ComponentMask componentMask) {
-			std::string typeName = std::string(typeid(T).name());
+		std::vector<ComponentStatistics> components; // Indexed by Component ID
+		std::vector<SystemStatistics> systems; // Indexed by System ID
 
-			NTSHENGN_ASSERT(m_systems.find(typeName) != m_systems.end(), "System does not exist.");
+		static std::string to_string(const ECSStatistics& statistics) {
+			std::string statisticsString = "Entities: " + std::to_string(statistics.entityCount) + "/" + std::to_string(statistics.maxEntities) + ", Indices: " + std::to_string(statistics.entityIndexCount) + " (" + std::to_string(statistics.availableEntityIndexCount) + " available), Bytes: " + std::to_string(statistics.entityBytes) + ".\n";
+			if (statistics.archetypeCount != 0) {
+				statisticsString += "Archetypes: " + std::to_string(statistics.archetypeCount) + ", Bytes: " + std::to_string(statistics.archetypeBytes) + ".\n";
+			}
+			for (const ComponentStatistics& componentStatistics : statistics.components) {
+				statisticsString += "\tComponent " + componentStatistics.name + ": Count: " + std::to_string(componentStatistics.count) + ", Capacity: " + std::to_string(componentStatistics.capacity) + ", Bytes: " + std::to_string(componentStatistics.bytes) + ", Fragmentation: " + std::to_string(componentStatistics.fragmentation) + ".\n";
+			}
+			for (const SystemStatistics& systemStatistics : statistics.systems) {
+				statisticsString += "\tSystem " + systemStatistics.name + ": Entities: " + std::to_string(systemStatistics.entityCount) + ".\n";
+			}
 
-			m_componentMasks.insert({ typeName, componentMask });
+			return statisticsString;
 		}
+	};
 
-		void entityDestroyed(Entity entity, ComponentMask entityComponents) {
-			for (const auto& pair : m_systems) {
-				const std::string& type = pair.first;
-				System* system = pair.second;
-				const ComponentMask systemComponentMask = m_componentMasks[type];
-				const ComponentMask entityAndSystemComponentMask = entityComponents & systemComponentMask;
+	// True on the threads running a job dispatched by the ECS (SystemManager::runSystems, ECSInterface::parallelForEach)
+	// JobSystemInterface::wait waits for every job, so dispatching and waiting from such a job would wait for the job itself
+	inline bool& runningECSJob() {
+		static thread_local bool running = false;
 
-				bool entityInSystem = false;
-				for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
-					if (entityAndSystemComponentMask[i]) {
-						entityInSystem = true;
-						system->onEntityComponentRemoved(entity, i);
-					}
-				}
+		return running;
+	}
 
-				if (entityInSystem) {
-					system->entities.erase(entity);
-				}
+	// Structural changes (Entity creation and destruction, Component addition and removal, names, persistence, groups) are not thread-safe
+	// Jobs dispatched by the ECS run concurrently and must record them in an ECSCommandBuffer
+	inline void checkStructuralChange() {
+#if defined(NTSHENGN_DEBUG)
+		NTSHENGN_ASSERT(!runningECSJob(), "Structural change made by a System running concurrently with others or by a parallelForEach job, use an ECSCommandBuffer.");
+#endif
+	}
+
+	class EntityManager {
+	public:
+		// The last index is never used so that NTSHENGN_ENTITY_UNKNOWN is never a valid Entity
+		EntityManager(uint32_t maxEntities = NTSHENGN_ENTITY_INDEX_MASK) : m_maxEntities(std::min<uint32_t>(maxEntities, NTSHENGN_ENTITY_INDEX_MASK)) {}
+		// Entity groups point to m_generations
+		EntityManager(const EntityManager&) = delete;
+		EntityManager& operator=(const EntityManager&) = delete;
+
+		Entity createEntity() {
+			checkStructuralChange();
+
+			NTSHENGN_ASSERT(m_numberOfEntities < m_maxEntities, "Too many Entities.");
+
+			uint32_t index;
+			if (!m_availableEntityIndices.empty()) {
+				index = m_availableEntityIndices.front();
+				m_availableEntityIndices.pop_front();
+			}
+			else {
+				index = static_cast<uint32_t>(m_generations.size());
+				m_generations.push_back(0);
+				m_componentMasks.push_back(ComponentMask());
 			}
+			m_numberOfEntities++;
+
+			Entity id = makeEntity(index, m_generations[index]);
+
+			m_existingEntities.insert(id);
+
+			return id;
 		}
 
-		void entityComponentMaskChanged(Entity entity, ComponentMask oldEntityComponentMask, ComponentMask newEntityComponentMask, Component componentID) {
-			for (const auto& pair : m_systems) {
-				const std::string& type = pair.first;
-				System* system = pair.second;
-				const ComponentMask systemComponentMask = m_componentMasks[type];
-				const ComponentMask oldAndSystemComponentMasks = oldEntityComponentMask & systemComponentMask;
-				const ComponentMask newAndSystemComponentMasks = newEntityComponentMask & systemComponentMask;
-				if (oldAndSystemComponentMasks != newAndSystemComponentMasks) { // A Component used in the system has been added or removed
-					if (newAndSystemComponentMasks.to_ulong() > oldAndSystemComponentMasks.to_ulong()) { // A Component has been added
-						system->onEntityComponentAdded(entity, componentID);
-						if (oldAndSystemComponentMasks.none()) { // The entity is new in the system
-							system->entities.insert(entity);
-						}
-					}
-					else if (newAndSystemComponentMasks.to_ulong() < oldAndSystemComponentMasks.to_ulong()) { // A Component has been removed
-						system->onEntityComponentRemoved(entity, componentID);
-						if (newAndSystemComponentMasks.none()) { // The entity has no more component for the system
-							system->entities.erase(entity);
-						}
-					}
-				}
-			}
+		// The Entity is created without a name if another Entity already has this name
+		Entity createEntity(std::string_view name) {
+			Entity id = createEntity();
+			setEntityName(id, name);
+
+			return id;
 		}
 
-	private:
-		std::unordered_map<std::string, ComponentMask> m_componentMasks;
-		std::unordered_map<std::string, System*> m_systems;
-	};
+		std::vector<Entity> createEntities(uint32_t count) {
+			checkStructuralChange();
 
-	class ECSInterface {
-	public:
-		virtual void init() = 0;
+			NTSHENGN_ASSERT((m_numberOfEntities + count) <= m_maxEntities, "Too many Entities.");
 
-		// Entity
-		virtual Entity createEntity() = 0;
-		virtual Entity createEntity(const std::string& name) = 0;
+			if (count > m_availableEntityIndices.size()) {
+				const size_t newIndexCount = count - m_availableEntityIndices.size();
+				m_generations.reserve(m_generations.size() + newIndexCount);
+				m_componentMasks.reserve(m_componentMasks.size() + newIndexCount);
+			}
 
-		virtual void destroyEntity(Entity entity) = 0;
-		virtual void destroyAllEntities() = 0;
-		virtual void destroyNonPersistentEntities() = 0;
+			std::vector<Entity> entities(count);
+			for (uint32_t i = 0; i < count; i++) {
+				entities[i] = createEntity();
+			}
 
-		virtual bool entityExists(Entity entity) = 0;
+			return entities;
+		}
 
-		virtual const std::set<Entity>& getEntities() = 0;
+		void destroyEntity(Entity entity) {
+			checkStructuralChange();
 
-		virtual void setEntityName(Entity entity, const std::string& name) = 0;
-		virtual bool entityHasName(Entity entity) = 0;
-		virtual std::string getEntityName(Entity entity) = 0;
-		virtual Entity findEntityByName(const std::string& name) = 0;
+			NTSHENGN_ASSERT(entityExists(entity), "Entity " + std::to_string(entity) + " does not exist.");
 
-		virtual void setEntityPersistence(Entity entity, bool persistent) = 0;
-		virtual bool isEntityPersistent(Entity entity) = 0;
+			const uint32_t index = getEntityIndex(entity);
 
-		virtual void addEntityToEntityGroup(Entity entity, const std::string& entityGroupName) = 0;
-		virtual void removeEntityFromEntityGroup(Entity entity, const std::string& entityGroupName) = 0;
+			// Entity groups read the generation of the Entity, it is removed from them before the generation changes
+			if (index < m_entityGroupsOfEntities.size()) {
+				for (EntityGroupID entityGroupID : m_entityGroupsOfEntities[index]) {
+					m_entityGroups[entityGroupID].erase(entity);
+					if (m_entityGroups[entityGroupID].empty()) {
+						releaseEntityGroup(entityGroupID);
+					}
+				}
+				m_entityGroupsOfEntities[index].clear();
+			}
 
-		virtual bool entityGroupExists(const std::string& entityGroupName) = 0;
+			// Indices are reused in FIFO order so that a generation takes as long as possible to wrap around
+			m_componentMasks[index].reset();
+			m_generations[index] = (m_generations[index] + 1) % NTSHENGN_ENTITY_GENERATION_DEFERRED;
+			m_availableEntityIndices.push_back(index);
+			m_numberOfEntities--;
 
-		virtual bool isEntityInEntityGroup(Entity entity, const std::string& entityGroupName) = 0;
-		virtual std::set<Entity> getEntitiesInEntityGroup(const std::string& entityGroupName) = 0;
-		virtual std::set<std::string> getEntityGroupsOfEntity(Entity entity) = 0;
+			m_existingEntities.erase(entity);
 
-		// Component
-		template <typename T>
-		void registerComponent() {
-			return m_componentManager->registerComponent<T>();
-		}
+			if ((index < m_entityNameIDs.size()) && (m_entityNameIDs[index] != NTSHENGN_NAME_UNKNOWN)) {
+				releaseName(m_entityNameIDs[index]);
+				m_entityNameIDs[index] = NTSHENGN_NAME_UNKNOWN;
+			}
 
-		template <typename T>
-		void addComponent(Entity entity, T component) {
-			m_componentManager->addComponent<T>(entity, component);
-			ComponentMask oldComponents = m_entityManager->getComponents(entity);
-			ComponentMask newComponents = oldComponents;
-			Component componentID = m_componentManager->getComponentID<T>();
-			newComponents.set(componentID, true);
-			m_entityManager->setComponents(entity, newComponents);
-			m_systemManager->entityComponentMaskChanged(entity, oldComponents, newComponents, componentID);
+			m_persistentEntities.erase(entity);
 		}
 
-		template <typename T>
-		void removeComponent(Entity entity) {
-			ComponentMask oldComponents = m_entityManager->getComponents(entity);
-			ComponentMask newComponents = oldComponents;
-			Component componentID = m_componentManager->getComponentID<T>();
-			newComponents.set(componentID, false);
-			m_entityManager->setComponents(entity, newComponents);
-			m_systemManager->entityComponentMaskChanged(entity, oldComponents, newComponents, componentID);
-			m_componentManager->removeComponent<T>(entity);
+		void destroyEntities(const std::vector<Entity>& entities) {
+			for (Entity entity : entities) {
+				destroyEntity(entity);
+			}
 		}
 
-		template <typename T>
-		bool hasComponent(Entity entity) {
-			return m_componentManager->hasComponent<T>(entity);
+		void setComponents(Entity entity, ComponentMask componentMask) {
+			NTSHENGN_ASSERT(entityExists(entity), "Entity " + std::to_string(entity) + " does not exist.");
+
+			m_componentMasks[getEntityIndex(entity)] = componentMask;
 		}
 
-		template <typename T>
-		T& getComponent(Entity entity) {
-			return m_componentManager->getComponent<T>(entity);
+		ComponentMask getComponents(Entity entity) {
+			NTSHENGN_ASSERT(entityExists(entity), "Entity " + std::to_string(entity) + " does not exist.");
+
+			return m_componentMasks[getEntityIndex(entity)];
 		}
 
-		template <typename T>
-		Component getComponentID() {
-			return m_componentManager->getComponentID<T>();
+		uint32_t getMaxEntities() const {
+			return m_maxEntities;
+		}
+
+		bool entityExists(Entity entity) {
+			return m_existingEntities.contains(entity);
+		}
+
+		const EntitySet& getExistingEntities() {
+			return m_existingEntities;
+		}
+
+		// Names are unique, returns false and keeps the current name of the Entity if another Entity already has this name
+		bool setEntityName(Entity entity, std::string_view name) {
+			checkStructuralChange();
+
+			NTSHENGN_ASSERT(entityExists(entity), "Entity " + std::to_string(entity) + " does not exist.");
+
+			const NameID nameID = internName(name);
+			if ((m_nameEntities[nameID] != NTSHENGN_ENTITY_UNKNOWN) && (m_nameEntities[nameID] != entity)) {
+				return false;
+			}
+
+			const uint32_t index = getEntityIndex(entity);
+			if (index >= m_entityNameIDs.size()) {
+				m_entityNameIDs.resize(index + 1, NTSHENGN_NAME_UNKNOWN);
+			}
+			if ((m_entityNameIDs[index] != NTSHENGN_NAME_UNKNOWN) && (m_entityNameIDs[index] != nameID)) {
+				releaseName(m_entityNameIDs[index]);
+			}
+			m_entityNameIDs[index] = nameID;
+			m_nameEntities[nameID] = entity;
+
+			return true;
+		}
+
+		bool entityHasName(Entity entity) {
+			return getEntityNameID(entity) != NTSHENGN_NAME_UNKNOWN;
+		}
+
+		NameID getEntityNameID(Entity entity) {
+			if (!entityExists(entity) || (getEntityIndex(entity) >= m_entityNameIDs.size())) {
+				return NTSHENGN_NAME_UNKNOWN;
+			}
+
+			return m_entityNameIDs[getEntityIndex(entity)];
+		}
+
+		// Returns an empty string if the Entity has no name
+		const std::string& getEntityName(Entity entity) {
+			return getName(getEntityNameID(entity));
+		}
+
+		Entity findEntityByName(std::string_view name) {
+			return findEntityByNameID(getNameID(name));
+		}
+
+		Entity findEntityByNameID(NameID nameID) {
+			if (nameID >= m_nameEntities.size()) {
+				return NTSHENGN_ENTITY_UNKNOWN;
+			}
+
+			return m_nameEntities[nameID];
+		}
+
+		// Returns NTSHENGN_NAME_UNKNOWN if no Entity has the name
+		NameID getNameID(std::string_view name) const {
+			std::unordered_map<std::string_view, NameID>::const_iterator it = m_nameIDs.find(name);
+			if (it == m_nameIDs.end()) {
+				return NTSHENGN_NAME_UNKNOWN;
+			}
+
+			return it->second;
+		}
+
+		const std::string& getName(NameID nameID) const {
+			static const std::string noName;
+			if (nameID >= m_names.size()) {
+				return noName;
+			}
+
+			return m_names[nameID];
+		}
+
+		void setEntityPersistence(Entity entity, bool persistent) {
+			checkStructuralChange();
+
+			if (persistent) {
+				m_persistentEntities.insert(entity);
+			}
+			else {
+				m_persistentEntities.erase(entity);
+			}
+		}
+
+		bool isEntityPersistent(Entity entity) {
+			return m_persistentEntities.contains(entity);
+		}
+
+		const EntitySet& getPersistentEntities() {
+			return m_persistentEntities;
+		}
+
+		void addEntityToEntityGroup(Entity entity, std::string_view entityGroupName) {
+			checkStructuralChange();
+
+			NTSHENGN_ASSERT(entityExists(entity), "Entity " + std::to_string(entity) + " does not exist.");
+
+			EntityGroupID entityGroupID = getEntityGroupID(entityGroupName);
+			if (entityGroupID == NTSHENGN_ENTITY_GROUP_UNKNOWN) {
+				if (!m_availableEntityGroupIDs.empty()) {
+					entityGroupID = m_availableEntityGroupIDs.front();
+					m_availableEntityGroupIDs.pop_front();
+					m_entityGroupNames[entityGroupID] = entityGroupName;
+					// Released Entity groups keep their storage until they are reused, as they can be released while being iterated
+					m_entityGroups[entityGroupID] = EntitySet(&m_generations);
+				}
+				else {
+					entityGroupID = static_cast<EntityGroupID>(m_entityGroupNames.size());
+					m_entityGroupNames.emplace_back(entityGroupName);
+					m_entityGroups.emplace_back(&m_generations);
+				}
+				m_entityGroupIDs.insert({ m_entityGroupNames[entityGroupID], entityGroupID });
+			}
+
+			if (m_entityGroups[entityGroupID].insert(entity)) {
+				const uint32_t index = getEntityIndex(entity);
+				if (index >= m_entityGroupsOfEntities.size()) {
+					m_entityGroupsOfEntities.resize(index + 1);
+				}
+				m_entityGroupsOfEntities[index].push_back(entityGroupID);
+			}
+		}
+
+		void removeEntityFromEntityGroup(Entity entity, std::string_view entityGroupName) {
+			checkStructuralChange();
+
+			const EntityGroupID entityGroupID = getEntityGroupID(entityGroupName);
+			if ((entityGroupID == NTSHENGN_ENTITY_GROUP_UNKNOWN) || (m_entityGroups[entityGroupID].erase(entity) == 0)) {
+				return;
+			}
+
+			std::vector<EntityGroupID>& entityGroupsOfEntity = m_entityGroupsOfEntities[getEntityIndex(entity)];
+			entityGroupsOfEntity.erase(std::find(entityGroupsOfEntity.begin(), entityGroupsOfEntity.end(), entityGroupID));
+			if (m_entityGroups[entityGroupID].empty()) {
+				releaseEntityGroup(entityGroupID);
+			}
+		}
+
+		// An Entity group exists as long as it has Entities
+		bool entityGroupExists(std::string_view entityGroupName) {
+			const EntityGroupID entityGroupID = getEntityGroupID(entityGroupName);
+
+			return (entityGroupID != NTSHENGN_ENTITY_GROUP_UNKNOWN) && !m_entityGroups[entityGroupID].empty();
+		}
+
+		bool isEntityInEntityGroup(Entity entity, std::string_view entityGroupName) {
+			return isEntityInEntityGroup(entity, getEntityGroupID(entityGroupName));
+		}
+
+		bool isEntityInEntityGroup(Entity entity, EntityGroupID entityGroupID) {
+			return (entityGroupID < m_entityGroups.size()) && m_entityGroups[entityGroupID].contains(entity);
+		}
+
+		const EntitySet& getEntitiesInEntityGroup(std::string_view entityGroupName) {
+			return getEntitiesInEntityGroup(getEntityGroupID(entityGroupName));
+		}
+
+		const EntitySet& getEntitiesInEntityGroup(EntityGroupID entityGroupID) {
+			static const EntitySet noEntities;
+			if (entityGroupID >= m_entityGroups.size()) {
+				return noEntities;
+			}
+
+			return m_entityGroups[entityGroupID];
+		}
+
+		const std::vector<EntityGroupID>& getEntityGroupsOfEntity(Entity entity) {
+			static const std::vector<EntityGroupID> noEntityGroups;
+			if (!entityExists(entity) || (getEntityIndex(entity) >= m_entityGroupsOfEntities.size())) {
+				return noEntityGroups;
+			}
+
+			return m_entityGroupsOfEntities[getEntityIndex(entity)];
+		}
+
+		// Returns NTSHENGN_ENTITY_GROUP_UNKNOWN if the Entity group has no Entities
+		EntityGroupID getEntityGroupID(std::string_view entityGroupName) const {
+			std::unordered_map<std::string_view, EntityGroupID>::const_iterator it = m_entityGroupIDs.find(entityGroupName);
+			if (it == m_entityGroupIDs.end()) {
+				return NTSHENGN_ENTITY_GROUP_UNKNOWN;
+			}
+
+			return it->second;
+		}
+
+		const std::string& getEntityGroupName(EntityGroupID entityGroupID) const {
+			static const std::string noName;
+			if (entityGroupID >= m_entityGroupNames.size()) {
+				return noName;
+			}
+
+			return m_entityGroupNames[entityGroupID];
+		}
+
+		void getStatistics(ECSStatistics& statistics) const {
+			statistics.entityCount = m_numberOfEntities;
+			statistics.entityIndexCount = m_generations.size();
+			statistics.availableEntityIndexCount = m_availableEntityIndices.size();
+			statistics.maxEntities = m_maxEntities;
+
+			size_t bytes = (m_availableEntityIndices.size() * sizeof(uint32_t)) + (m_generations.capacity() * sizeof(uint32_t)) + (m_componentMasks.capacity() * sizeof(ComponentMask));
+			bytes += m_existingEntities.getMemorySize() + m_persistentEntities.getMemorySize();
+			for (const std::string& name : m_names) {
+				bytes += sizeof(std::string) + name.capacity();
+			}
+			bytes += (m_nameEntities.capacity() * sizeof(Entity)) + (m_entityNameIDs.capacity() * sizeof(NameID)) + (m_availableNameIDs.size() * sizeof(NameID));
+			for (size_t i = 0; i < m_entityGroups.size(); i++) {
+				bytes += sizeof(std::string) + m_entityGroupNames[i].capacity() + sizeof(EntitySet) + m_entityGroups[i].getMemorySize();
+			}
+			for (const std::vector<EntityGroupID>& entityGroupsOfEntity : m_entityGroupsOfEntities) {
+				bytes += sizeof(std::vector<EntityGroupID>) + (entityGroupsOfEntity.capacity() * sizeof(EntityGroupID));
+			}
+			bytes += m_availableEntityGroupIDs.size() * sizeof(EntityGroupID);
+			statistics.entityBytes = bytes;
+		}
+
+		void writeSnapshot(Buffer& snapshot) {
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(m_generations.size()));
+			writeSnapshotValues(snapshot, m_generations.data(), m_generations.size());
+
+			const std::vector<uint32_t> availableEntityIndices(m_availableEntityIndices.begin(), m_availableEntityIndices.end());
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(availableEntityIndices.size()));
+			writeSnapshotValues(snapshot, availableEntityIndices.data(), availableEntityIndices.size());
+
+			writeEntitySetSnapshot(snapshot, m_existingEntities);
+			writeEntitySetSnapshot(snapshot, m_persistentEntities);
+
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(m_names.size()));
+			for (const std::string& name : m_names) {
+				writeSnapshotString(snapshot, name);
+			}
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(m_entityNameIDs.size()));
+			writeSnapshotValues(snapshot, m_entityNameIDs.data(), m_entityNameIDs.size());
+
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(m_entityGroups.size()));
+			for (size_t i = 0; i < m_entityGroups.size(); i++) {
+				writeSnapshotString(snapshot, m_entityGroupNames[i]);
+				writeEntitySetSnapshot(snapshot, m_entityGroups[i]);
+			}
+		}
+
+		// Replaces every Entity with the ones of the snapshot, without Components
+		// Component masks depend on the Component registration order, they are rebuilt from the Components read by ComponentManager::readSnapshot
+		void readSnapshot(Buffer& snapshot) {
+			m_generations.resize(readSnapshotValue<uint32_t>(snapshot));
+			readSnapshotValues(snapshot, m_generations.data(), m_generations.size());
+			m_componentMasks.assign(m_generations.size(), ComponentMask());
+
+			std::vector<uint32_t> availableEntityIndices(readSnapshotValue<uint32_t>(snapshot));
+			readSnapshotValues(snapshot, availableEntityIndices.data(), availableEntityIndices.size());
+			m_availableEntityIndices.assign(availableEntityIndices.begin(), availableEntityIndices.end());
+
+			readEntitySetSnapshot(snapshot, m_existingEntities);
+			readEntitySetSnapshot(snapshot, m_persistentEntities);
+			m_numberOfEntities = static_cast<uint32_t>(m_existingEntities.size());
+
+			// Released names and Entity groups are the ones without Entities
+			m_names.clear();
+			m_nameIDs.clear();
+			m_availableNameIDs.clear();
+			const uint32_t nameCount = readSnapshotValue<uint32_t>(snapshot);
+			for (uint32_t i = 0; i < nameCount; i++) {
+				m_names.push_back(readSnapshotString(snapshot));
+			}
+			m_entityNameIDs.resize(readSnapshotValue<uint32_t>(snapshot));
+			readSnapshotValues(snapshot, m_entityNameIDs.data(), m_entityNameIDs.size());
+			m_nameEntities.assign(m_names.size(), NTSHENGN_ENTITY_UNKNOWN);
+			for (Entity entity : m_existingEntities) {
+				const uint32_t index = getEntityIndex(entity);
+				if ((index < m_entityNameIDs.size()) && (m_entityNameIDs[index] != NTSHENGN_NAME_UNKNOWN)) {
+					m_nameEntities[m_entityNameIDs[index]] = entity;
+				}
+			}
+			for (NameID nameID = 0; nameID < m_names.size(); nameID++) {
+				if (m_nameEntities[nameID] != NTSHENGN_ENTITY_UNKNOWN) {
+					m_nameIDs.insert({ m_names[nameID], nameID });
+				}
+				else {
+					m_names[nameID] = std::string();
+					m_availableNameIDs.push_back(nameID);
+				}
+			}
+
+			m_entityGroupNames.clear();
+			m_entityGroupIDs.clear();
+			m_availableEntityGroupIDs.clear();
+			m_entityGroupsOfEntities.assign(m_generations.size(), std::vector<EntityGroupID>());
+			m_entityGroups.clear();
+			const uint32_t entityGroupCount = readSnapshotValue<uint32_t>(snapshot);
+			for (uint32_t i = 0; i < entityGroupCount; i++) {
+				m_entityGroups.emplace_back(&m_generations);
+			}
+			for (size_t i = 0; i < m_entityGroups.size(); i++) {
+				m_entityGroupNames.push_back(readSnapshotString(snapshot));
+				readEntitySetSnapshot(snapshot, m_entityGroups[i]);
+				if (m_entityGroups[i].empty()) {
+					m_entityGroupNames.back() = std::string();
+					m_availableEntityGroupIDs.push_back(static_cast<EntityGroupID>(i));
+
+					continue;
+				}
+
+				m_entityGroupIDs.insert({ m_entityGroupNames.back(), static_cast<EntityGroupID>(i) });
+				for (Entity entity : m_entityGroups[i]) {
+					m_entityGroupsOfEntities[getEntityIndex(entity)].push_back(static_cast<EntityGroupID>(i));
+				}
+			}
+		}
+
+	private:
+		static void writeEntitySetSnapshot(Buffer& snapshot, const EntitySet& entitySet) {
+			const std::vector<Entity> entities(entitySet.begin(), entitySet.end());
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(entities.size()));
+			writeSnapshotValues(snapshot, entities.data(), entities.size());
+		}
+
+		static void readEntitySetSnapshot(Buffer& snapshot, EntitySet& entitySet) {
+			std::vector<Entity> entities(readSnapshotValue<uint32_t>(snapshot));
+			readSnapshotValues(snapshot, entities.data(), entities.size());
+			entitySet.clear();
+			for (Entity entity : entities) {
+				entitySet.insert(entity);
+			}
+		}
+
+		NameID internName(std::string_view name) {
+			const NameID nameID = getNameID(name);
+			if (nameID != NTSHENGN_NAME_UNKNOWN) {
+				return nameID;
+			}
+
+			NameID newNameID;
+			if (!m_availableNameIDs.empty()) {
+				newNameID = m_availableNameIDs.front();
+				m_availableNameIDs.pop_front();
+				m_names[newNameID] = name;
+			}
+			else {
+				newNameID = static_cast<NameID>(m_names.size());
+				m_names.emplace_back(name);
+				m_nameEntities.push_back(NTSHENGN_ENTITY_UNKNOWN);
+			}
+			m_nameIDs.insert({ m_names[newNameID], newNameID });
+
+			return newNameID;
+		}
+
+		// NameIDs and EntityGroupIDs are reused in FIFO order, like Entity indices
+		void releaseName(NameID nameID) {
+			m_nameIDs.erase(m_names[nameID]);
+			m_names[nameID] = std::string();
+			m_nameEntities[nameID] = NTSHENGN_ENTITY_UNKNOWN;
+			m_availableNameIDs.push_back(nameID);
+		}
+
+		void releaseEntityGroup(EntityGroupID entityGroupID) {
+			m_entityGroupIDs.erase(m_entityGroupNames[entityGroupID]);
+			m_entityGroupNames[entityGroupID] = std::string();
+			m_availableEntityGroupIDs.push_back(entityGroupID);
+		}
+
+	private:
+		std::deque<uint32_t> m_availableEntityIndices;
+		std::vector<uint32_t> m_generations;
+		EntitySet m_existingEntities;
+		std::vector<ComponentMask> m_componentMasks;
+		// Interned names, the string_view keys point into m_names, whose elements never move
+		std::deque<std::string> m_names;
+		std::unordered_map<std::string_view, NameID> m_nameIDs;
+		std::vector<Entity> m_nameEntities; // Indexed by NameID
+		std::vector<NameID> m_entityNameIDs; // Indexed by Entity index
+		std::deque<NameID> m_availableNameIDs;
+		EntitySet m_persistentEntities;
+		// Entity groups, the string_view keys point into m_entityGroupNames, whose elements never move
+		std::deque<std::string> m_entityGroupNames;
+		std::unordered_map<std::string_view, EntityGroupID> m_entityGroupIDs;
+		std::vector<EntitySet> m_entityGroups; // Indexed by EntityGroupID
+		std::vector<std::vector<EntityGroupID>> m_entityGroupsOfEntities; // Indexed by Entity index
+		std::deque<EntityGroupID> m_availableEntityGroupIDs;
+		uint32_t m_numberOfEntities = 0;
+		uint32_t m_maxEntities;
+	};
+
+	class ComponentArrayInterface {
+	public:
+		virtual ~ComponentArrayInterface() = default;
+		virtual void entityDestroyed(Entity entity) = 0;
+		virtual void entitiesDestroyed(const std::vector<Entity>& entities) = 0;
+
+		virtual size_t size() const = 0;
+		// Components fitting in the allocated pages
+		virtual size_t capacity() const = 0;
+		// Allocated bytes, including the sparse pages and the dense Entities
+		virtual size_t getMemorySize() const = 0;
+
+		// Only available for SnapshotComponents, written as the dense Entities followed by the dense Components
+		virtual void writeSnapshot(Buffer& snapshot) = 0;
+		// The ComponentArray must be empty, entities receives the Entities read
+		virtual void readSnapshot(Buffer& snapshot, std::vector<Entity>& entities) = 0;
+	};
+
+	// Sparse set: the sparse pages map an Entity to its index in the dense Entities and Components arrays
+	// Pages are allocated when they are first used, and Component pages are never moved when the array grows
+	// Component pages are uninitialized memory, Components are only constructed when they are inserted
+	template <typename T>
+	class ComponentArray : public ComponentArrayInterface {
+	public:
+		ComponentArray() = default;
+		ComponentArray(const ComponentArray&) = delete;
+		ComponentArray& operator=(const ComponentArray&) = delete;
+		~ComponentArray() {
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (size_t index = 0; index < m_entities.size(); index++) {
+					getComponent(index).~T();
+				}
+			}
+		}
+
+		// Constructs the Component in place
+		template <typename... Args>
+		T& emplaceData(Entity entity, Args&&... args) {
+			NTSHENGN_ASSERT(!hasComponent(entity), "Entity " + std::to_string(entity) + " already has this component.");
+
+			const size_t index = m_entities.size();
+			if ((index / NTSHENGN_COMPONENT_PAGE_SIZE) == m_componentPages.size()) {
+				m_componentPages.emplace_back(static_cast<T*>(::operator new(sizeof(T) * NTSHENGN_COMPONENT_PAGE_SIZE, std::align_val_t(alignof(T)))));
+			}
+
+			T* component = new (m_componentPages[index / NTSHENGN_COMPONENT_PAGE_SIZE].get() + (index % NTSHENGN_COMPONENT_PAGE_SIZE)) T(std::forward<Args>(args)...);
+			createSparseIndex(entity) = static_cast<uint32_t>(index);
+			m_entities.push_back(entity);
+
+			return *component;
+		}
+
+		void insertData(Entity entity, T&& component) {
+			emplaceData(entity, std::move(component));
+		}
+
+		void insertData(Entity entity, const T& component) {
+			emplaceData(entity, component);
+		}
+
+		void insertData(const std::vector<Entity>& entities, const T& component) {
+			m_entities.reserve(m_entities.size() + entities.size());
+			for (Entity entity : entities) {
+				emplaceData(entity, component);
+			}
+		}
+
+		// The last Component is moved in place of the removed one
+		void removeData(Entity entity) {
+			NTSHENGN_ASSERT(hasComponent(entity), "Entity " + std::to_string(entity) + " does not have this component.");
+
+			const uint32_t index = getSparseIndex(entity);
+			const size_t lastIndex = m_entities.size() - 1;
+			const Entity entityLast = m_entities.back();
+			if (index != lastIndex) {
+				getComponent(index) = std::move(getComponent(lastIndex));
+			}
+			getComponent(lastIndex).~T();
+			m_entities[index] = entityLast;
+			getSparseIndex(entityLast) = index;
+			getSparseIndex(entity) = NTSHENGN_COMPONENT_INDEX_UNKNOWN;
+			m_entities.pop_back();
+
+			// Keep one empty page to avoid reallocating when an Entity is added right after
+			const size_t usedComponentPages = (m_entities.size() + NTSHENGN_COMPONENT_PAGE_SIZE - 1) / NTSHENGN_COMPONENT_PAGE_SIZE;
+			if (m_componentPages.size() > (usedComponentPages + 1)) {
+				m_componentPages.pop_back();
+			}
+		}
+
+		bool hasComponent(Entity entity) {
+			const uint32_t entityIndex = getEntityIndex(entity);
+			const size_t sparsePageIndex = entityIndex / NTSHENGN_COMPONENT_PAGE_SIZE;
+			if ((sparsePageIndex >= m_sparsePages.size()) || !m_sparsePages[sparsePageIndex]) {
+				return false;
+			}
+
+			const uint32_t index = m_sparsePages[sparsePageIndex][entityIndex % NTSHENGN_COMPONENT_PAGE_SIZE];
+
+			return (index < m_entities.size()) && (m_entities[index] == entity);
+		}
+
+		T& getData(Entity entity) {
+			NTSHENGN_ASSERT(hasComponent(entity), "Entity " + std::to_string(entity) + " does not have this component.");
+
+			return getComponent(getSparseIndex(entity));
+		}
+
+		void entityDestroyed(Entity entity) override {
+			if (hasComponent(entity)) {
+				removeData(entity);
+			}
+		}
+
+		void entitiesDestroyed(const std::vector<Entity>& entities) override {
+			for (Entity entity : entities) {
+				if (hasComponent(entity)) {
+					removeData(entity);
+				}
+			}
+		}
+
+		size_t size() const override {
+			return m_entities.size();
+		}
+
+		size_t capacity() const override {
+			return m_componentPages.size() * NTSHENGN_COMPONENT_PAGE_SIZE;
+		}
+
+		size_t getMemorySize() const override {
+			size_t bytes = (m_componentPages.size() * sizeof(T) * NTSHENGN_COMPONENT_PAGE_SIZE) + (m_sparsePages.capacity() * sizeof(std::unique_ptr<uint32_t[]>)) + (m_entities.capacity() * sizeof(Entity));
+			for (const std::unique_ptr<uint32_t[]>& sparsePage : m_sparsePages) {
+				if (sparsePage) {
+					bytes += NTSHENGN_COMPONENT_PAGE_SIZE * sizeof(uint32_t);
+				}
+			}
+
+			return bytes;
+		}
+
+		// Entities having this Component, in the same order as the Components
+		const std::vector<Entity>& getEntities() const {
+			return m_entities;
+		}
+
+		void writeSnapshot(Buffer& snapshot) override {
+			if constexpr (SnapshotComponent<T>::value) {
+				writeSnapshotValue(snapshot, static_cast<uint32_t>(m_entities.size()));
+				writeSnapshotValues(snapshot, m_entities.data(), m_entities.size());
+				for (size_t index = 0; index < m_entities.size(); index += NTSHENGN_COMPONENT_PAGE_SIZE) {
+					writeSnapshotValues(snapshot, m_componentPages[index / NTSHENGN_COMPONENT_PAGE_SIZE].get(), std::min<size_t>(NTSHENGN_COMPONENT_PAGE_SIZE, m_entities.size() - index));
+				}
+			}
+			else {
+				NTSHENGN_UNUSED(snapshot);
+				NTSHENGN_ASSERT(false, "Component is not a SnapshotComponent.");
+			}
+		}
+
+		void readSnapshot(Buffer& snapshot, std::vector<Entity>& entities) override {
+			if constexpr (SnapshotComponent<T>::value) {
+				NTSHENGN_ASSERT(m_entities.empty(), "ComponentArray must be empty to read a snapshot.");
+
+				entities.resize(readSnapshotValue<uint32_t>(snapshot));
+				readSnapshotValues(snapshot, entities.data(), entities.size());
+				for (size_t index = 0; index < entities.size(); index++) {
+					createSparseIndex(entities[index]) = static_cast<uint32_t>(index);
+				}
+				m_entities = entities;
+
+				for (size_t index = 0; index < m_entities.size(); index += NTSHENGN_COMPONENT_PAGE_SIZE) {
+					if ((index / NTSHENGN_COMPONENT_PAGE_SIZE) == m_componentPages.size()) {
+						m_componentPages.emplace_back(static_cast<T*>(::operator new(sizeof(T) * NTSHENGN_COMPONENT_PAGE_SIZE, std::align_val_t(alignof(T)))));
+					}
+					readSnapshotValues(snapshot, m_componentPages[index / NTSHENGN_COMPONENT_PAGE_SIZE].get(), std::min<size_t>(NTSHENGN_COMPONENT_PAGE_SIZE, m_entities.size() - index));
+				}
+			}
+			else {
+				NTSHENGN_UNUSED(snapshot);
+				NTSHENGN_UNUSED(entities);
+				NTSHENGN_ASSERT(false, "Component is not trivially copyable.");
+			}
+		}
+
+	private:
+		// Allocates the sparse page of the Entity if needed
+		uint32_t& createSparseIndex(Entity entity) {
+			const uint32_t entityIndex = getEntityIndex(entity);
+			const size_t sparsePageIndex = entityIndex / NTSHENGN_COMPONENT_PAGE_SIZE;
+			if (sparsePageIndex >= m_sparsePages.size()) {
+				m_sparsePages.resize(sparsePageIndex + 1);
+			}
+			if (!m_sparsePages[sparsePageIndex]) {
+				m_sparsePages[sparsePageIndex] = std::make_unique<uint32_t[]>(NTSHENGN_COMPONENT_PAGE_SIZE);
+				std::fill_n(m_sparsePages[sparsePageIndex].get(), NTSHENGN_COMPONENT_PAGE_SIZE, NTSHENGN_COMPONENT_INDEX_UNKNOWN);
+			}
+
+			return m_sparsePages[sparsePageIndex][entityIndex % NTSHENGN_COMPONENT_PAGE_SIZE];
+		}
+
+		uint32_t& getSparseIndex(Entity entity) {
+			const uint32_t entityIndex = getEntityIndex(entity);
+
+			return m_sparsePages[entityIndex / NTSHENGN_COMPONENT_PAGE_SIZE][entityIndex % NTSHENGN_COMPONENT_PAGE_SIZE];
+		}
+
+		T& getComponent(size_t index) {
+			return *std::launder(m_componentPages[index / NTSHENGN_COMPONENT_PAGE_SIZE].get() + (index % NTSHENGN_COMPONENT_PAGE_SIZE));
+		}
+
+		struct ComponentPageDeleter {
+			void operator()(T* componentPage) const {
+				::operator delete(componentPage, std::align_val_t(alignof(T)));
+			}
+		};
+
+	private:
+		std::vector<std::unique_ptr<T, ComponentPageDeleter>> m_componentPages;
+		std::vector<std::unique_ptr<uint32_t[]>> m_sparsePages;
+		std::vector<Entity> m_entities;
+	};
+
+	// Array: each Component type has its own ComponentArray
+	// Archetype: Entities sharing the same ComponentMask are stored together, references to Components are invalidated when Components are added or removed
+	enum class ComponentStorageType {
+		Array,
+		Archetype
+	};
+
+	struct ComponentTypeInfo {
+		const char* typeName = nullptr;
+		size_t size = 0;
+		size_t alignment = 0;
+		bool savedInSnapshots = false;
+		void (*moveConstruct)(void* destination, void* source) = nullptr;
+		void (*destruct)(void* component) = nullptr;
+
+		template <typename T>
+		static ComponentTypeInfo create() {
+			ComponentTypeInfo componentTypeInfo;
+			componentTypeInfo.typeName = typeid(T).name();
+			componentTypeInfo.size = sizeof(T);
+			componentTypeInfo.alignment = alignof(T);
+			static_assert(!SnapshotComponent<T>::value || std::is_trivially_copyable_v<T>, "SnapshotComponents must be trivially copyable.");
+			componentTypeInfo.savedInSnapshots = SnapshotComponent<T>::value;
+			componentTypeInfo.moveConstruct = [](void* destination, void* source) {
+				new (destination) T(std::move(*static_cast<T*>(source)));
+			};
+			componentTypeInfo.destruct = [](void* component) {
+				static_cast<T*>(component)->~T();
+			};
+
+			return componentTypeInfo;
+		}
+	};
+
+	class ArchetypeChunk {
+	public:
+		ArchetypeChunk(size_t chunkSize) : m_data(static_cast<std::byte*>(::operator new(chunkSize, std::align_val_t(NTSHENGN_ARCHETYPE_CHUNK_ALIGNMENT)))) {}
+		ArchetypeChunk(const ArchetypeChunk&) = delete;
+		ArchetypeChunk& operator=(const ArchetypeChunk&) = delete;
+		~ArchetypeChunk() {
+			::operator delete(m_data, std::align_val_t(NTSHENGN_ARCHETYPE_CHUNK_ALIGNMENT));
+		}
+
+		std::byte* getData() {
+			return m_data;
+		}
+
+	public:
+		uint32_t size = 0;
+
+	private:
+		std::byte* m_data;
+	};
+
+	// Entities sharing the same ComponentMask, stored in fixed-size chunks
+	// Each chunk holds an Entity column followed by one column per Component (SoA)
+	class Archetype {
+	public:
+		Archetype(ComponentMask componentMask, const std::array<ComponentTypeInfo, NTSHENGN_MAX_COMPONENTS>& componentTypeInfos) : mask(componentMask) {
+			addEdges.fill(NTSHENGN_ARCHETYPE_UNKNOWN);
+			removeEdges.fill(NTSHENGN_ARCHETYPE_UNKNOWN);
+			columnOffsets.fill(0);
+
+			size_t rowSize = sizeof(Entity);
+			size_t alignmentPadding = 0;
+			for (Component i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				if (mask[i]) {
+					NTSHENGN_ASSERT(componentTypeInfos[i].alignment <= NTSHENGN_ARCHETYPE_CHUNK_ALIGNMENT, "Component alignment is too large for Archetype storage.");
+
+					components.push_back(i);
+					rowSize += componentTypeInfos[i].size;
+					alignmentPadding += componentTypeInfos[i].alignment;
+				}
+			}
+
+			// Big Components get bigger chunks so that a chunk always holds at least one Entity
+			chunkSize = std::max(static_cast<size_t>(NTSHENGN_ARCHETYPE_CHUNK_SIZE), rowSize + alignmentPadding);
+			chunkCapacity = static_cast<uint32_t>((chunkSize - alignmentPadding) / rowSize);
+
+			size_t offset = sizeof(Entity) * chunkCapacity;
+			for (Component component : components) {
+				const size_t alignment = componentTypeInfos[component].alignment;
+				offset = ((offset + alignment - 1) / alignment) * alignment;
+				columnOffsets[component] = offset;
+				offset += componentTypeInfos[component].size * chunkCapacity;
+			}
+		}
+
+		Entity* getEntities(size_t chunkIndex) {
+			return reinterpret_cast<Entity*>(chunks[chunkIndex]->getData());
+		}
+
+		void* getComponent(size_t chunkIndex, Component componentID, size_t componentSize, uint32_t row) {
+			return chunks[chunkIndex]->getData() + columnOffsets[componentID] + (componentSize * row);
+		}
+
+		template <typename T>
+		T* getColumn(size_t chunkIndex, Component componentID) {
+			return std::launder(reinterpret_cast<T*>(chunks[chunkIndex]->getData() + columnOffsets[componentID]));
+		}
+
+	public:
+		ComponentMask mask;
+		std::vector<Component> components;
+		std::array<size_t, NTSHENGN_MAX_COMPONENTS> columnOffsets;
+		size_t chunkSize;
+		uint32_t chunkCapacity;
+		std::vector<std::unique_ptr<ArchetypeChunk>> chunks;
+		uint32_t size = 0;
+
+		// Cached Archetype transitions when adding or removing a Component
+		std::array<uint32_t, NTSHENGN_MAX_COMPONENTS> addEdges;
+		std::array<uint32_t, NTSHENGN_MAX_COMPONENTS> removeEdges;
+	};
+
+	class ArchetypeStorage {
+	public:
+		ArchetypeStorage(const std::array<ComponentTypeInfo, NTSHENGN_MAX_COMPONENTS>& componentTypeInfos) : m_componentTypeInfos(componentTypeInfos) {}
+
+		~ArchetypeStorage() {
+			for (std::unique_ptr<Archetype>& archetype : m_archetypes) {
+				for (uint32_t row = 0; row < archetype->size; row++) {
+					destructRow(*archetype, row);
+				}
+			}
+		}
+
+		template <typename T>
+		void insertData(Entity entity, Component componentID, T&& component) {
+			emplaceData<std::decay_t<T>>(entity, componentID, std::forward<T>(component));
+		}
+
+		// Moves the Entity to its new Archetype and constructs the Component in place
+		template <typename T, typename... Args>
+		T& emplaceData(Entity entity, Component componentID, Args&&... args) {
+			NTSHENGN_ASSERT(!hasComponent(entity, componentID), "Entity " + std::to_string(entity) + " already has this component.");
+
+			if (getEntityIndex(entity) >= m_entityLocations.size()) {
+				m_entityLocations.resize(getEntityIndex(entity) + 1);
+			}
+			EntityLocation& location = m_entityLocations[getEntityIndex(entity)];
+			uint32_t destinationArchetypeIndex = getAddEdge(location.archetype, componentID);
+			moveEntity(entity, destinationArchetypeIndex);
+
+			return *new (getData(entity, componentID)) T(std::forward<Args>(args)...);
+		}
+
+		// Places Entities without Components directly in the Archetype of the mask, the Components are left uninitialized
+		void insertEntities(const std::vector<Entity>& entities, ComponentMask componentMask) {
+			const uint32_t archetypeIndex = findOrCreateArchetype(componentMask);
+			for (Entity entity : entities) {
+				if (getEntityIndex(entity) >= m_entityLocations.size()) {
+					m_entityLocations.resize(getEntityIndex(entity) + 1);
+				}
+
+				NTSHENGN_ASSERT((m_entityLocations[getEntityIndex(entity)].entity != entity) || (m_entityLocations[getEntityIndex(entity)].archetype == NTSHENGN_ARCHETYPE_UNKNOWN), "Entity " + std::to_string(entity) + " already has components.");
+
+				moveEntity(entity, archetypeIndex);
+			}
+		}
+
+		void removeData(Entity entity, Component componentID) {
+			NTSHENGN_ASSERT(hasComponent(entity, componentID), "Entity " + std::to_string(entity) + " does not have this component.");
+
+			const EntityLocation& location = m_entityLocations[getEntityIndex(entity)];
+			uint32_t destinationArchetypeIndex = getRemoveEdge(location.archetype, componentID);
+			moveEntity(entity, destinationArchetypeIndex);
+		}
+
+		bool hasComponent(Entity entity, Component componentID) {
+			if (getEntityIndex(entity) >= m_entityLocations.size()) {
+				return false;
+			}
+
+			const EntityLocation& location = m_entityLocations[getEntityIndex(entity)];
+
+			return (location.entity == entity) && (location.archetype != NTSHENGN_ARCHETYPE_UNKNOWN) && m_archetypes[location.archetype]->mask[componentID];
+		}
+
+		void* getData(Entity entity, Component componentID) {
+			NTSHENGN_ASSERT(hasComponent(entity, componentID), "Entity " + std::to_string(entity) + " does not have this component.");
+
+			const EntityLocation& location = m_entityLocations[getEntityIndex(entity)];
+			Archetype& archetype = *m_archetypes[location.archetype];
+
+			return archetype.getComponent(location.row / archetype.chunkCapacity, componentID, m_componentTypeInfos[componentID].size, location.row % archetype.chunkCapacity);
+		}
+
+		void entityDestroyed(Entity entity) {
+			if ((getEntityIndex(entity) < m_entityLocations.size()) && (m_entityLocations[getEntityIndex(entity)].entity == entity) && (m_entityLocations[getEntityIndex(entity)].archetype != NTSHENGN_ARCHETYPE_UNKNOWN)) {
+				moveEntity(entity, NTSHENGN_ARCHETYPE_UNKNOWN);
+			}
+		}
+
+		// Adds the Archetype chunks to the statistics of their Components
+		void getStatistics(ECSStatistics& statistics) const {
+			statistics.archetypeCount = m_archetypes.size();
+			statistics.archetypeBytes = m_entityLocations.capacity() * sizeof(EntityLocation);
+			for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+				const size_t capacity = archetype->chunks.size() * archetype->chunkCapacity;
+				statistics.archetypeBytes += archetype->chunks.size() * archetype->chunkSize;
+				for (Component component : archetype->components) {
+					statistics.components[component].count += archetype->size;
+					statistics.components[component].capacity += capacity;
+					statistics.components[component].bytes += capacity * m_componentTypeInfos[component].size;
+				}
+			}
+		}
+
+		// Non-empty Archetypes having all the Components of the mask
+		std::vector<Archetype*> getArchetypes(ComponentMask componentMask) {
+			std::vector<Archetype*> archetypes;
+			for (std::unique_ptr<Archetype>& archetype : m_archetypes) {
+				if ((archetype->size != 0) && ((archetype->mask & componentMask) == componentMask)) {
+					archetypes.push_back(archetype.get());
+				}
+			}
+
+			return archetypes;
+		}
+
+	private:
+		struct EntityLocation {
+			Entity entity = NTSHENGN_ENTITY_UNKNOWN;
+			uint32_t archetype = NTSHENGN_ARCHETYPE_UNKNOWN;
+			uint32_t row = 0;
+		};
+
+		uint32_t findOrCreateArchetype(ComponentMask componentMask) {
+			for (uint32_t i = 0; i < m_archetypes.size(); i++) {
+				if (m_archetypes[i]->mask == componentMask) {
+					return i;
+				}
+			}
+
+			m_archetypes.push_back(std::make_unique<Archetype>(componentMask, m_componentTypeInfos));
+
+			return static_cast<uint32_t>(m_archetypes.size() - 1);
+		}
+
+		uint32_t getAddEdge(uint32_t archetypeIndex, Component componentID) {
+			if (archetypeIndex == NTSHENGN_ARCHETYPE_UNKNOWN) {
+				ComponentMask componentMask;
+				componentMask.set(componentID);
+
+				return findOrCreateArchetype(componentMask);
+			}
+
+			if (m_archetypes[archetypeIndex]->addEdges[componentID] == NTSHENGN_ARCHETYPE_UNKNOWN) {
+				ComponentMask componentMask = m_archetypes[archetypeIndex]->mask;
+				componentMask.set(componentID);
+				m_archetypes[archetypeIndex]->addEdges[componentID] = findOrCreateArchetype(componentMask);
+			}
+
+			return m_archetypes[archetypeIndex]->addEdges[componentID];
+		}
+
+		uint32_t getRemoveEdge(uint32_t archetypeIndex, Component componentID) {
+			if (m_archetypes[archetypeIndex]->removeEdges[componentID] == NTSHENGN_ARCHETYPE_UNKNOWN) {
+				ComponentMask componentMask = m_archetypes[archetypeIndex]->mask;
+				componentMask.reset(componentID);
+				if (componentMask.none()) {
+					return NTSHENGN_ARCHETYPE_UNKNOWN;
+				}
+				m_archetypes[archetypeIndex]->removeEdges[componentID] = findOrCreateArchetype(componentMask);
+			}
+
+			return m_archetypes[archetypeIndex]->removeEdges[componentID];
+		}
+
+		// Moves the Components shared by both Archetypes, destructs the ones missing in the destination
+		// Components only present in the destination are left uninitialized
+		void moveEntity(Entity entity, uint32_t destinationArchetypeIndex) {
+			EntityLocation& location = m_entityLocations[getEntityIndex(entity)];
+			const uint32_t sourceArchetypeIndex = location.archetype;
+			const uint32_t sourceRow = location.row;
+
+			uint32_t destinationRow = 0;
+			if (destinationArchetypeIndex != NTSHENGN_ARCHETYPE_UNKNOWN) {
+				Archetype& destinationArchetype = *m_archetypes[destinationArchetypeIndex];
+				destinationRow = destinationArchetype.size;
+				const size_t chunkIndex = destinationRow / destinationArchetype.chunkCapacity;
+				if (chunkIndex == destinationArchetype.chunks.size()) {
+					destinationArchetype.chunks.push_back(std::make_unique<ArchetypeChunk>(destinationArchetype.chunkSize));
+				}
+				destinationArchetype.getEntities(chunkIndex)[destinationRow % destinationArchetype.chunkCapacity] = entity;
+				destinationArchetype.chunks[chunkIndex]->size++;
+				destinationArchetype.size++;
+
+				if (sourceArchetypeIndex != NTSHENGN_ARCHETYPE_UNKNOWN) {
+					Archetype& sourceArchetype = *m_archetypes[sourceArchetypeIndex];
+					for (Component component : sourceArchetype.components) {
+						if (destinationArchetype.mask[component]) {
+							const size_t componentSize = m_componentTypeInfos[component].size;
+							m_componentTypeInfos[component].moveConstruct(destinationArchetype.getComponent(chunkIndex, component, componentSize, destinationRow % destinationArchetype.chunkCapacity), sourceArchetype.getComponent(sourceRow / sourceArchetype.chunkCapacity, component, componentSize, sourceRow % sourceArchetype.chunkCapacity));
+						}
+					}
+				}
+			}
+
+			if (sourceArchetypeIndex != NTSHENGN_ARCHETYPE_UNKNOWN) {
+				removeRow(*m_archetypes[sourceArchetypeIndex], sourceRow);
+			}
+
+			location.entity = entity;
+			location.archetype = destinationArchetypeIndex;
+			location.row = destinationRow;
+		}
+
+		void destructRow(Archetype& archetype, uint32_t row) {
+			for (Component component : archetype.components) {
+				m_componentTypeInfos[component].destruct(archetype.getComponent(row / archetype.chunkCapacity, component, m_componentTypeInfos[component].size, row % archetype.chunkCapacity));
+			}
+		}
+
+		// Swap-removes a row, the last row of the Archetype takes its place
+		void removeRow(Archetype& archetype, uint32_t row) {
+			destructRow(archetype, row);
+
+			const uint32_t lastRow = archetype.size - 1;
+			const size_t lastChunkIndex = lastRow / archetype.chunkCapacity;
+			if (row != lastRow) {
+				const size_t chunkIndex = row / archetype.chunkCapacity;
+				for (Component component : archetype.components) {
+					const size_t componentSize = m_componentTypeInfos[component].size;
+					void* lastComponent = archetype.getComponent(lastChunkIndex, component, componentSize, lastRow % archetype.chunkCapacity);
+					m_componentTypeInfos[component].moveConstruct(archetype.getComponent(chunkIndex, component, componentSize, row % archetype.chunkCapacity), lastComponent);
+					m_componentTypeInfos[component].destruct(lastComponent);
+				}
+
+				const Entity lastEntity = archetype.getEntities(lastChunkIndex)[lastRow % archetype.chunkCapacity];
+				archetype.getEntities(chunkIndex)[row % archetype.chunkCapacity] = lastEntity;
+				m_entityLocations[getEntityIndex(lastEntity)].row = row;
+			}
+
+			archetype.chunks[lastChunkIndex]->size--;
+			archetype.size--;
+			if (archetype.chunks[lastChunkIndex]->size == 0) {
+				archetype.chunks.pop_back();
+			}
+		}
+
+	private:
+		const std::array<ComponentTypeInfo, NTSHENGN_MAX_COMPONENTS>& m_componentTypeInfos;
+		std::vector<std::unique_ptr<Archetype>> m_archetypes;
+		std::vector<EntityLocation> m_entityLocations;
+	};
+
+	// Iterates over every Entity having all the Components, yielding (entity, components...) tuples of references
+	// With ComponentStorageType::Array, the smallest ComponentArray is walked and the other ones are probed
+	// With ComponentStorageType::Archetype, the matching Archetypes are walked chunk by chunk
+	// Components must not be added or removed during the iteration
+	// Non-const Components are marked as changed when visited, const Components are not
+	template <typename... Components>
+	class ComponentView {
+	public:
+		typedef std::tuple<Entity, Components&...> Element;
+
+		class Iterator {
+		public:
+			Iterator(ComponentView* view, size_t archetypeIndex, size_t position) : m_view(view), m_archetypeIndex(archetypeIndex), m_position(position) {}
+
+			Element operator*() const {
+				return m_view->get(m_archetypeIndex, m_position, std::index_sequence_for<Components...>());
+			}
+
+			Iterator& operator++() {
+				m_view->next(m_archetypeIndex, m_position);
+
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const {
+				return (m_archetypeIndex == other.m_archetypeIndex) && (m_position == other.m_position);
+			}
+
+			bool operator!=(const Iterator& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			ComponentView* m_view;
+			size_t m_archetypeIndex;
+			size_t m_position;
+		};
+
+	public:
+		ComponentView(const std::tuple<ComponentArray<std::remove_const_t<Components>>*...>& componentArrays, const std::array<Component, sizeof...(Components)>& componentIDs, std::array<std::vector<uint32_t>, NTSHENGN_MAX_COMPONENTS>* changeTicks, uint32_t changeTick) : m_storageType(ComponentStorageType::Array), m_componentArrays(componentArrays), m_componentIDs(componentIDs), m_changeTicks(changeTicks), m_changeTick(changeTick) {
+			findSmallestComponentArray(std::index_sequence_for<Components...>());
+		}
+
+		ComponentView(const std::vector<Archetype*>& archetypes, const std::array<Component, sizeof...(Components)>& componentIDs, std::array<std::vector<uint32_t>, NTSHENGN_MAX_COMPONENTS>* changeTicks, uint32_t changeTick) : m_storageType(ComponentStorageType::Archetype), m_archetypes(archetypes), m_componentIDs(componentIDs), m_changeTicks(changeTicks), m_changeTick(changeTick) {}
+
+		Iterator begin() {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				return Iterator(this, 0, 0);
+			}
+
+			size_t position = 0;
+			while ((position < m_smallestEntities->size()) && !hasComponents((*m_smallestEntities)[position], std::index_sequence_for<Components...>())) {
+				position++;
+			}
+
+			return Iterator(this, 0, position);
+		}
+
+		Iterator end() {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				return Iterator(this, m_archetypes.size(), 0);
+			}
+
+			return Iterator(this, 0, m_smallestEntities->size());
+		}
+
+		// Calls function(entity, components...) for every Entity of the view
+		template <typename Function>
+		void each(Function&& function) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				for (Archetype* archetype : m_archetypes) {
+					for (size_t chunkIndex = 0; chunkIndex < archetype->chunks.size(); chunkIndex++) {
+						eachInChunk(*archetype, chunkIndex, 0, archetype->chunks[chunkIndex]->size, function, std::index_sequence_for<Components...>());
+					}
+				}
+			}
+			else {
+				for (Entity entity : *m_smallestEntities) {
+					if (hasComponents(entity, std::index_sequence_for<Components...>())) {
+						callWithComponents(entity, function, std::index_sequence_for<Components...>());
+					}
+				}
+			}
+		}
+
+		// Upper bound of the number of Entities in the view, positions in [0, getRangeSize()) can be split with eachInRange
+		size_t getRangeSize() const {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				size_t rangeSize = 0;
+				for (const Archetype* archetype : m_archetypes) {
+					rangeSize += archetype->size;
+				}
+
+				return rangeSize;
+			}
+
+			return m_smallestEntities->size();
+		}
+
+		// Calls function(entity, components...) for every Entity of the view in positions [rangeBegin, rangeEnd)
+		// Disjoint ranges can be iterated concurrently, as long as the Components are not added or removed
+		template <typename Function>
+		void eachInRange(size_t rangeBegin, size_t rangeEnd, Function&& function) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				size_t archetypeBegin = 0;
+				for (Archetype* archetype : m_archetypes) {
+					const size_t archetypeEnd = archetypeBegin + archetype->size;
+					if (archetypeEnd <= rangeBegin) {
+						archetypeBegin = archetypeEnd;
+						continue;
+					}
+					if (archetypeBegin >= rangeEnd) {
+						break;
+					}
+
+					const size_t positionBegin = std::max(rangeBegin, archetypeBegin) - archetypeBegin;
+					const size_t positionEnd = std::min(rangeEnd, archetypeEnd) - archetypeBegin;
+					for (size_t chunkIndex = positionBegin / archetype->chunkCapacity; (chunkIndex * archetype->chunkCapacity) < positionEnd; chunkIndex++) {
+						const size_t chunkBegin = chunkIndex * archetype->chunkCapacity;
+						const uint32_t rowBegin = static_cast<uint32_t>(std::max(positionBegin, chunkBegin) - chunkBegin);
+						const uint32_t rowEnd = static_cast<uint32_t>(std::min(positionEnd, chunkBegin + archetype->chunkCapacity) - chunkBegin);
+						eachInChunk(*archetype, chunkIndex, rowBegin, rowEnd, function, std::index_sequence_for<Components...>());
+					}
+
+					archetypeBegin = archetypeEnd;
+				}
+			}
+			else {
+				const size_t positionEnd = std::min(rangeEnd, m_smallestEntities->size());
+				for (size_t position = rangeBegin; position < positionEnd; position++) {
+					const Entity entity = (*m_smallestEntities)[position];
+					if (hasComponents(entity, std::index_sequence_for<Components...>())) {
+						callWithComponents(entity, function, std::index_sequence_for<Components...>());
+					}
+				}
+			}
+		}
+
+	private:
+		template <size_t... Indices>
+		void findSmallestComponentArray(std::index_sequence<Indices...>) {
+			m_smallestEntities = &std::get<0>(m_componentArrays)->getEntities();
+			((m_smallestEntities = (std::get<Indices>(m_componentArrays)->size() < m_smallestEntities->size()) ? &std::get<Indices>(m_componentArrays)->getEntities() : m_smallestEntities), ...);
+		}
+
+		template <size_t... Indices>
+		bool hasComponents(Entity entity, std::index_sequence<Indices...>) const {
+			return (std::get<Indices>(m_componentArrays)->hasComponent(entity) && ...);
+		}
+
+		template <size_t Index>
+		void markChanged(Entity entity) {
+			if constexpr (!std::is_const_v<std::tuple_element_t<Index, std::tuple<Components...>>>) {
+				(*m_changeTicks)[m_componentIDs[Index]][getEntityIndex(entity)] = m_changeTick;
+			}
+			else {
+				NTSHENGN_UNUSED(entity);
+			}
+		}
+
+		template <typename Function, size_t... Indices>
+		void callWithComponents(Entity entity, Function& function, std::index_sequence<Indices...>) {
+			(markChanged<Indices>(entity), ...);
+			function(entity, std::get<Indices>(m_componentArrays)->getData(entity)...);
+		}
+
+		template <typename Function, size_t... Indices>
+		void eachInChunk(Archetype& archetype, size_t chunkIndex, uint32_t rowBegin, uint32_t rowEnd, Function& function, std::index_sequence<Indices...>) {
+			const Entity* entities = archetype.getEntities(chunkIndex);
+			const std::tuple<std::remove_const_t<Components>*...> columns = { archetype.getColumn<std::remove_const_t<Components>>(chunkIndex, m_componentIDs[Indices])... };
+
+			for (uint32_t row = rowBegin; row < rowEnd; row++) {
+				(markChanged<Indices>(entities[row]), ...);
+				function(entities[row], std::get<Indices>(columns)[row]...);
+			}
+		}
+
+		template <size_t... Indices>
+		Element get(size_t archetypeIndex, size_t position, std::index_sequence<Indices...>) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				Archetype& archetype = *m_archetypes[archetypeIndex];
+				const size_t chunkIndex = position / archetype.chunkCapacity;
+				const size_t row = position % archetype.chunkCapacity;
+				(markChanged<Indices>(archetype.getEntities(chunkIndex)[row]), ...);
+
+				return Element(archetype.getEntities(chunkIndex)[row], archetype.getColumn<std::remove_const_t<Components>>(chunkIndex, m_componentIDs[Indices])[row]...);
+			}
+
+			const Entity entity = (*m_smallestEntities)[position];
+			(markChanged<Indices>(entity), ...);
+
+			return Element(entity, std::get<Indices>(m_componentArrays)->getData(entity)...);
+		}
+
+		void next(size_t& archetypeIndex, size_t& position) {
+			position++;
+			if (m_storageType == ComponentStorageType::Archetype) {
+				if (position == m_archetypes[archetypeIndex]->size) {
+					archetypeIndex++;
+					position = 0;
+				}
+			}
+			else {
+				while ((position < m_smallestEntities->size()) && !hasComponents((*m_smallestEntities)[position], std::index_sequence_for<Components...>())) {
+					position++;
+				}
+			}
+		}
+
+	private:
+		ComponentStorageType m_storageType;
+
+		// ComponentStorageType::Array
+		std::tuple<ComponentArray<std::remove_const_t<Components>>*...> m_componentArrays;
+		const std::vector<Entity>* m_smallestEntities = nullptr;
+
+		// ComponentStorageType::Archetype
+		std::vector<Archetype*> m_archetypes;
+		std::array<Component, sizeof...(Components)> m_componentIDs;
+
+		std::array<std::vector<uint32_t>, NTSHENGN_MAX_COMPONENTS>* m_changeTicks;
+		uint32_t m_changeTick;
+	};
+
+#if defined(NTSHENGN_DEBUG)
+	// Written Components of the System run by SystemManager::runSystems on the calling thread, nullptr outside of runSystems
+	inline const ComponentMask*& runningSystemWriteComponentMask() {
+		static thread_local const ComponentMask* writeComponentMask = nullptr;
+
+		return writeComponentMask;
+	}
+#endif
+
+	class ComponentManager {
+	public:
+		ComponentManager(ComponentStorageType storageType = ComponentStorageType::Array) : m_storageType(storageType) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				m_archetypeStorage = std::make_unique<ArchetypeStorage>(m_componentTypeInfos);
+			}
+		}
+
+		template <typename T>
+		void registerComponent() {
+			NTSHENGN_ASSERT(m_componentTypes.size() < NTSHENGN_MAX_COMPONENTS, "Too many Components.");
+
+			const Component componentID = static_cast<Component>(m_componentTypes.registerType<T>());
+			m_componentTypeInfos[componentID] = ComponentTypeInfo::create<T>();
+			if (m_storageType == ComponentStorageType::Array) {
+				m_componentArrays.push_back(std::make_unique<ComponentArray<T>>());
+			}
+		}
+
+		template <typename T>
+		Component getComponentID() {
+			const uint32_t componentID = m_componentTypes.getID<T>();
+
+			NTSHENGN_ASSERT(componentID != NTSHENGN_TYPE_ID_UNKNOWN, "Component is not registered.");
+
+			return static_cast<Component>(componentID);
+		}
+
+		template <typename T>
+		T& addComponent(Entity entity, T component) {
+			return emplaceComponent<T>(entity, std::move(component));
+		}
+
+		// Constructs the Component in place with args and returns it
+		template <typename T, typename... Args>
+		T& emplaceComponent(Entity entity, Args&&... args) {
+			checkStructuralChange();
+
+			markChanged(entity, getComponentID<T>());
+			if (m_storageType == ComponentStorageType::Archetype) {
+				return m_archetypeStorage->emplaceData<T>(entity, getComponentID<T>(), std::forward<Args>(args)...);
+			}
+
+			return getComponentArray<T>()->emplaceData(entity, std::forward<Args>(args)...);
+		}
+
+		// Gives a copy of each Component to Entities without Components
+		template <typename... Components>
+		void addComponents(const std::vector<Entity>& entities, const Components&... components) {
+			checkStructuralChange();
+
+			if (m_storageType == ComponentStorageType::Archetype) {
+				ComponentMask componentMask;
+				(componentMask.set(getComponentID<Components>()), ...);
+				m_archetypeStorage->insertEntities(entities, componentMask);
+				for (Entity entity : entities) {
+					(new (m_archetypeStorage->getData(entity, getComponentID<Components>())) Components(components), ...);
+				}
+			}
+			else {
+				(getComponentArray<Components>()->insertData(entities, components), ...);
+			}
+			for (Entity entity : entities) {
+				(markChanged(entity, getComponentID<Components>()), ...);
+			}
+		}
+
+		template <typename T>
+		void removeComponent(Entity entity) {
+			checkStructuralChange();
+
+			if (m_storageType == ComponentStorageType::Archetype) {
+				m_archetypeStorage->removeData(entity, getComponentID<T>());
+			}
+			else {
+				getComponentArray<T>()->removeData(entity);
+			}
+		}
+
+		template <typename T>
+		bool hasComponent(Entity entity) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				return m_archetypeStorage->hasComponent(entity, getComponentID<T>());
+			}
+
+			return getComponentArray<T>()->hasComponent(entity);
+		}
+
+		// Marks the Component as changed
+		template <typename T>
+		T& getComponent(Entity entity) {
+			checkWriteAccess(getComponentID<T>());
+
+			T& component = getComponentData<T>(entity);
+			markChanged(entity, getComponentID<T>());
+
+			return component;
+		}
+
+		template <typename T>
+		const T& readComponent(Entity entity) {
+			return getComponentData<T>(entity);
+		}
+
+		// Returns the Entities having the Component T changed after lastChangeTick, then sets lastChangeTick to the current change tick
+		// Adding a Component counts as a change
+		template <typename T>
+		std::vector<Entity> changed(uint32_t& lastChangeTick) {
+			const Component componentID = getComponentID<T>();
+			const std::vector<uint32_t>& changeTicks = m_changeTicks[componentID];
+
+			std::vector<Entity> changedEntities;
+			if (m_storageType == ComponentStorageType::Archetype) {
+				ComponentMask componentMask;
+				componentMask.set(componentID);
+				for (Archetype* archetype : m_archetypeStorage->getArchetypes(componentMask)) {
+					for (size_t chunkIndex = 0; chunkIndex < archetype->chunks.size(); chunkIndex++) {
+						const Entity* entities = archetype->getEntities(chunkIndex);
+						const uint32_t chunkSize = archetype->chunks[chunkIndex]->size;
+						for (uint32_t row = 0; row < chunkSize; row++) {
+							if (changeTicks[getEntityIndex(entities[row])] > lastChangeTick) {
+								changedEntities.push_back(entities[row]);
+							}
+						}
+					}
+				}
+			}
+			else {
+				for (Entity entity : getComponentArray<T>()->getEntities()) {
+					if (changeTicks[getEntityIndex(entity)] > lastChangeTick) {
+						changedEntities.push_back(entity);
+					}
+				}
+			}
+
+			// Later changes get a greater tick than the one returned
+			lastChangeTick = m_changeTick++;
+
+			return changedEntities;
+		}
+
+		uint32_t getChangeTick() const {
+			return m_changeTick;
+		}
+
+		// Writes the SnapshotComponents, skippedComponents receives the other Components that some Entities have
+		void writeSnapshot(Buffer& snapshot, ComponentMask& skippedComponents) {
+			std::vector<Component> componentIDs;
+			skippedComponents.reset();
+			for (Component componentID = 0; componentID < m_componentTypes.size(); componentID++) {
+				if (m_componentTypeInfos[componentID].savedInSnapshots) {
+					componentIDs.push_back(componentID);
+				}
+				else if (getComponentCount(componentID) != 0) {
+					skippedComponents.set(componentID);
+				}
+			}
+
+			writeSnapshotValue(snapshot, static_cast<uint32_t>(componentIDs.size()));
+			for (Component componentID : componentIDs) {
+				const ComponentTypeInfo& componentTypeInfo = m_componentTypeInfos[componentID];
+				writeSnapshotString(snapshot, componentTypeInfo.typeName);
+				writeSnapshotValue(snapshot, static_cast<uint64_t>(componentTypeInfo.size));
+
+				if (m_storageType == ComponentStorageType::Array) {
+					m_componentArrays[componentID]->writeSnapshot(snapshot);
+
+					continue;
+				}
+
+				// Same layout as ComponentArray, columns are copied chunk by chunk
+				ComponentMask componentMask;
+				componentMask.set(componentID);
+				const std::vector<Archetype*> archetypes = m_archetypeStorage->getArchetypes(componentMask);
+				uint32_t entityCount = 0;
+				for (Archetype* archetype : archetypes) {
+					entityCount += archetype->size;
+				}
+				writeSnapshotValue(snapshot, entityCount);
+				for (Archetype* archetype : archetypes) {
+					for (size_t chunkIndex = 0; chunkIndex < archetype->chunks.size(); chunkIndex++) {
+						writeSnapshotValues(snapshot, archetype->getEntities(chunkIndex), archetype->chunks[chunkIndex]->size);
+					}
+				}
+				for (Archetype* archetype : archetypes) {
+					for (size_t chunkIndex = 0; chunkIndex < archetype->chunks.size(); chunkIndex++) {
+						writeSnapshotValues(snapshot, static_cast<const std::byte*>(archetype->getComponent(chunkIndex, componentID, componentTypeInfo.size, 0)), componentTypeInfo.size * archetype->chunks[chunkIndex]->size);
+					}
+				}
+			}
+		}
+
+		// Entities must not have Components, entityComponentMasks receives the Components read for each Entity index, with this ComponentManager's Component IDs
+		void readSnapshot(Buffer& snapshot, std::vector<ComponentMask>& entityComponentMasks) {
+			std::vector<std::pair<Component, std::vector<Entity>>> componentEntities(readSnapshotValue<uint32_t>(snapshot));
+			std::vector<std::vector<std::byte>> componentData(componentEntities.size());
+			for (size_t i = 0; i < componentEntities.size(); i++) {
+				const std::string typeName = readSnapshotString(snapshot);
+				const uint64_t componentSize = readSnapshotValue<uint64_t>(snapshot);
+				const uint32_t componentID = m_componentTypes.getID(typeName);
+
+				NTSHENGN_ASSERT(componentID != NTSHENGN_TYPE_ID_UNKNOWN, "Component \"" + typeName + "\" is not registered.");
+				NTSHENGN_ASSERT(componentSize == m_componentTypeInfos[componentID].size, "Component \"" + typeName + "\" has changed since the snapshot was written.");
+				NTSHENGN_UNUSED(componentSize);
+
+				componentEntities[i].first = static_cast<Component>(componentID);
+				std::vector<Entity>& entities = componentEntities[i].second;
+				if (m_storageType == ComponentStorageType::Array) {
+					m_componentArrays[componentID]->readSnapshot(snapshot, entities);
+				}
+				else {
+					entities.resize(readSnapshotValue<uint32_t>(snapshot));
+					readSnapshotValues(snapshot, entities.data(), entities.size());
+					componentData[i].resize(entities.size() * m_componentTypeInfos[componentID].size);
+					readSnapshotValues(snapshot, componentData[i].data(), componentData[i].size());
+				}
+
+				for (Entity entity : entities) {
+					markChanged(entity, componentEntities[i].first);
+				}
+			}
+
+			std::vector<Entity> entities;
+			entityComponentMasks.clear();
+			for (const std::pair<Component, std::vector<Entity>>& componentEntity : componentEntities) {
+				for (Entity entity : componentEntity.second) {
+					const uint32_t entityIndex = getEntityIndex(entity);
+					if (entityIndex >= entityComponentMasks.size()) {
+						entityComponentMasks.resize(entityIndex + 1);
+					}
+					if (entityComponentMasks[entityIndex].none()) {
+						entities.push_back(entity);
+					}
+					entityComponentMasks[entityIndex].set(componentEntity.first);
+				}
+			}
+
+			if (m_storageType == ComponentStorageType::Archetype) {
+				// Entities are moved to their final Archetype at once, in batches of Entities sharing the same Components
+				std::unordered_map<unsigned long, std::vector<Entity>> entitiesByComponentMask;
+				for (Entity entity : entities) {
+					entitiesByComponentMask[entityComponentMasks[getEntityIndex(entity)].to_ulong()].push_back(entity);
+				}
+				for (const std::pair<const unsigned long, std::vector<Entity>>& entitiesWithComponentMask : entitiesByComponentMask) {
+					m_archetypeStorage->insertEntities(entitiesWithComponentMask.second, ComponentMask(entitiesWithComponentMask.first));
+				}
+
+				for (size_t i = 0; i < componentEntities.size(); i++) {
+					const Component componentID = componentEntities[i].first;
+					const size_t componentSize = m_componentTypeInfos[componentID].size;
+					for (size_t j = 0; j < componentEntities[i].second.size(); j++) {
+						std::memcpy(m_archetypeStorage->getData(componentEntities[i].second[j], componentID), componentData[i].data() + (j * componentSize), componentSize);
+					}
+				}
+			}
+		}
+
+		void entityDestroyed(Entity entity) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				m_archetypeStorage->entityDestroyed(entity);
+
+				return;
+			}
+
+			for (const std::unique_ptr<ComponentArrayInterface>& componentArray : m_componentArrays) {
+				componentArray->entityDestroyed(entity);
+			}
+		}
+
+		void entitiesDestroyed(const std::vector<Entity>& entities) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				for (Entity entity : entities) {
+					m_archetypeStorage->entityDestroyed(entity);
+				}
+
+				return;
+			}
+
+			for (const std::unique_ptr<ComponentArrayInterface>& componentArray : m_componentArrays) {
+				componentArray->entitiesDestroyed(entities);
+			}
+		}
+
+		ComponentStorageType getStorageType() const {
+			return m_storageType;
+		}
+
+		size_t getComponentCount(Component componentID) const {
+			if (m_storageType == ComponentStorageType::Array) {
+				return m_componentArrays[componentID]->size();
+			}
+
+			ComponentMask componentMask;
+			componentMask.set(componentID);
+			size_t componentCount = 0;
+			for (Archetype* archetype : m_archetypeStorage->getArchetypes(componentMask)) {
+				componentCount += archetype->size;
+			}
+
+			return componentCount;
+		}
+
+		// Component bytes include the change ticks
+		void getStatistics(ECSStatistics& statistics) const {
+			statistics.components.resize(m_componentTypes.size());
+			for (Component componentID = 0; componentID < statistics.components.size(); componentID++) {
+				ComponentStatistics& componentStatistics = statistics.components[componentID];
+				componentStatistics.name = m_componentTypes.getDisplayName(componentID);
+				componentStatistics.componentID = componentID;
+				componentStatistics.bytes = m_changeTicks[componentID].capacity() * sizeof(uint32_t);
+				if (m_storageType == ComponentStorageType::Array) {
+					componentStatistics.count = m_componentArrays[componentID]->size();
+					componentStatistics.capacity = m_componentArrays[componentID]->capacity();
+					componentStatistics.bytes += m_componentArrays[componentID]->getMemorySize();
+				}
+			}
+			if (m_storageType == ComponentStorageType::Archetype) {
+				m_archetypeStorage->getStatistics(statistics);
+			}
+
+			for (ComponentStatistics& componentStatistics : statistics.components) {
+				componentStatistics.fragmentation = (componentStatistics.capacity != 0) ? 1.0 - (static_cast<double>(componentStatistics.count) / static_cast<double>(componentStatistics.capacity)) : 0.0;
+			}
+		}
+
+		template <typename... Components>
+		ComponentView<Components...> view() {
+			(checkWriteAccess(std::is_const_v<Components> ? NTSHENGN_MAX_COMPONENTS : getComponentID<std::remove_const_t<Components>>()), ...);
+
+			if (m_storageType == ComponentStorageType::Archetype) {
+				ComponentMask componentMask;
+				const std::array<Component, sizeof...(Components)> componentIDs = { getComponentID<std::remove_const_t<Components>>()... };
+				for (Component componentID : componentIDs) {
+					componentMask.set(componentID);
+				}
+
+				return ComponentView<Components...>(m_archetypeStorage->getArchetypes(componentMask), componentIDs, &m_changeTicks, m_changeTick);
+			}
+
+			return ComponentView<Components...>(std::make_tuple(getComponentArray<std::remove_const_t<Components>>()...), { getComponentID<std::remove_const_t<Components>>()... }, &m_changeTicks, m_changeTick);
+		}
+
+	private:
+		TypeIDRegistry m_componentTypes;
+		std::vector<std::unique_ptr<ComponentArrayInterface>> m_componentArrays;
+		std::array<ComponentTypeInfo, NTSHENGN_MAX_COMPONENTS> m_componentTypeInfos;
+
+		// Archetype storage (in ComponentStorageType::Archetype mode)
+		ComponentStorageType m_storageType;
+		std::unique_ptr<ArchetypeStorage> m_archetypeStorage;
+
+		// Change ticks, indexed by Component ID and Entity index
+		std::array<std::vector<uint32_t>, NTSHENGN_MAX_COMPONENTS> m_changeTicks;
+		uint32_t m_changeTick = 1;
+
+		template <typename T>
+		ComponentArray<T>* getComponentArray() {
+			return static_cast<ComponentArray<T>*>(m_componentArrays[getComponentID<T>()].get());
+		}
+
+		template <typename T>
+		T& getComponentData(Entity entity) {
+			if (m_storageType == ComponentStorageType::Archetype) {
+				return *std::launder(static_cast<T*>(m_archetypeStorage->getData(entity, getComponentID<T>())));
+			}
+
+			return getComponentArray<T>()->getData(entity);
+		}
+
+		void markChanged(Entity entity, Component componentID) {
+			std::vector<uint32_t>& changeTicks = m_changeTicks[componentID];
+			const uint32_t entityIndex = getEntityIndex(entity);
+			if (entityIndex >= changeTicks.size()) {
+				changeTicks.resize(entityIndex + 1, 0);
+			}
+			changeTicks[entityIndex] = m_changeTick;
+		}
+
+		// Change ticks are shared by all Systems, a System running concurrently with others must only mark the Components it writes
+		void checkWriteAccess(uint32_t componentID) {
+#if defined(NTSHENGN_DEBUG)
+			const ComponentMask* writeComponentMask = runningSystemWriteComponentMask();
+			NTSHENGN_ASSERT(!writeComponentMask || (componentID == NTSHENGN_MAX_COMPONENTS) || (*writeComponentMask)[componentID], "Component " + m_componentTypes.getDisplayName(componentID) + " is accessed mutably by a System that does not write it, use readComponent or a const Component.");
+#else
+			NTSHENGN_UNUSED(componentID);
+#endif
+		}
+	};
+
+	class System {
+	public:
+		virtual void onEntityComponentAdded(Entity entity, Component componentID) { NTSHENGN_UNUSED(entity); NTSHENGN_UNUSED(componentID); }
+		virtual void onEntityComponentRemoved(Entity entity, Component componentID) { NTSHENGN_UNUSED(entity); NTSHENGN_UNUSED(componentID); }
+
+		// Called once per Component for a batch of Entities, forwarded to the single Entity callbacks by default
+		virtual void onEntitiesComponentAdded(const std::vector<Entity>& addedEntities, Component componentID) {
+			for (Entity entity : addedEntities) {
+				onEntityComponentAdded(entity, componentID);
+			}
+		}
+		virtual void onEntitiesComponentRemoved(const std::vector<Entity>& removedEntities, Component componentID) {
+			for (Entity entity : removedEntities) {
+				onEntityComponentRemoved(entity, componentID);
+			}
+		}
+
+	public:
+		EntitySet entities;
+	};
+
+	// Receives the Entities that got or lost an observed Component, batched once per ECSInterface::notifyObservers
+	// Entities may have been destroyed since the event, and an Entity can be in both lists if its Component was added and removed
+	class ComponentObserver {
+	public:
+		virtual void onComponentsAdded(const std::vector<Entity>& entities, Component componentID) { NTSHENGN_UNUSED(entities); NTSHENGN_UNUSED(componentID); }
+		virtual void onComponentsRemoved(const std::vector<Entity>& entities, Component componentID) { NTSHENGN_UNUSED(entities); NTSHENGN_UNUSED(componentID); }
+	};
+
+	class SystemManager {
+	public:
+		template <typename T>
+		void registerSystem(System* system) {
+			m_systemTypes.registerType<T>();
+			m_systems.push_back(system);
+			m_componentMasks.push_back(ComponentMask());
+			// Until their access is declared, Systems write all Components and never run concurrently
+			m_readComponentMasks.push_back(ComponentMask());
+			m_writeComponentMasks.push_back(ComponentMask().set());
+			m_internalSystems.push_back(false);
+			m_scheduleOutdated = true;
+		}
+
+		// Internal Systems receive Entities like other Systems but are updated by the ECS itself, runSystems never calls them
+		template <typename T>
+		void registerInternalSystem(System* system) {
+			registerSystem<T>(system);
+			m_internalSystems.back() = true;
+		}
+
+		template <typename T>
+		void setComponents(ComponentMask componentMask) {
+			const uint32_t systemID = m_systemTypes.getID<T>();
+
+			NTSHENGN_ASSERT(systemID != NTSHENGN_TYPE_ID_UNKNOWN, "System does not exist.");
+
+			m_componentMasks[systemID] = componentMask;
+
+			for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				std::vector<uint32_t>& componentSystems = m_componentSystems[i];
+				componentSystems.erase(std::remove(componentSystems.begin(), componentSystems.end(), systemID), componentSystems.end());
+				if (componentMask[i]) {
+					componentSystems.insert(std::upper_bound(componentSystems.begin(), componentSystems.end(), systemID), systemID);
+				}
+			}
+		}
+
+		template <typename T>
+		void setComponentAccess(ComponentMask readComponentMask, ComponentMask writeComponentMask) {
+			const uint32_t systemID = m_systemTypes.getID<T>();
+
+			NTSHENGN_ASSERT(systemID != NTSHENGN_TYPE_ID_UNKNOWN, "System does not exist.");
+
+			m_readComponentMasks[systemID] = readComponentMask;
+			m_writeComponentMasks[systemID] = writeComponentMask;
+			m_scheduleOutdated = true;
+		}
+
+		// Calls function(system) for every non-internal System, in registration order for Systems with conflicting Component accesses
+		// Systems without conflicts are run concurrently on the job system, as jobs that must not wait on the job system, parallelForEach runs inline in them
+		// Systems run concurrently must not make structural changes directly (Entity creation and destruction, Component addition and removal, names, persistence, groups) and must record them in an ECSCommandBuffer (asserted in debug builds)
+		void runSystems(JobSystemInterface* jobSystem, const std::function<void(System*)>& function) {
+			if (m_scheduleOutdated) {
+				buildSchedule();
+			}
+
+			for (const std::vector<uint32_t>& scheduleStage : m_scheduleStages) {
+				if ((scheduleStage.size() == 1) || !jobSystem) {
+					for (uint32_t systemID : scheduleStage) {
+						runSystem(systemID, function);
+					}
+
+					continue;
+				}
+
+				jobSystem->dispatch(static_cast<uint32_t>(scheduleStage.size()), 1, [this, &scheduleStage, &function](JobDispatchArguments args) {
+					runningECSJob() = true;
+					runSystem(scheduleStage[args.jobIndex], function);
+					runningECSJob() = false;
+				});
+				jobSystem->wait();
+			}
+		}
+
+		void registerObserver(ComponentObserver* observer, Component componentID) {
+			m_observers[componentID].push_back(observer);
+			m_observedComponents.set(componentID);
+		}
+
+		void unregisterObserver(ComponentObserver* observer, Component componentID) {
+			std::vector<ComponentObserver*>& observers = m_observers[componentID];
+			observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+			if (observers.empty()) {
+				m_observedComponents.reset(componentID);
+				m_addedEntities[componentID].clear();
+				m_removedEntities[componentID].clear();
+			}
+		}
+
+		// Delivers the Component events recorded since the last call, additions before removals
+		void notifyObservers() {
+			for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				if (!m_observedComponents[i]) {
+					continue;
+				}
+
+				// Events recorded by the observers are delivered on the next call
+				std::swap(m_addedEntities[i], m_deliveredEntities);
+				if (!m_deliveredEntities.empty()) {
+					for (ComponentObserver* observer : m_observers[i]) {
+						observer->onComponentsAdded(m_deliveredEntities, i);
+					}
+				}
+				m_deliveredEntities.clear();
+
+				std::swap(m_removedEntities[i], m_deliveredEntities);
+				if (!m_deliveredEntities.empty()) {
+					for (ComponentObserver* observer : m_observers[i]) {
+						observer->onComponentsRemoved(m_deliveredEntities, i);
+					}
+				}
+				m_deliveredEntities.clear();
+			}
+		}
+
+		const std::vector<std::vector<uint32_t>>& getScheduleStages() {
+			if (m_scheduleOutdated) {
+				buildSchedule();
+			}
+
+			return m_scheduleStages;
+		}
+
+		void getStatistics(ECSStatistics& statistics) const {
+			statistics.systems.resize(m_systems.size());
+			for (uint32_t systemID = 0; systemID < m_systems.size(); systemID++) {
+				statistics.systems[systemID].name = m_systemTypes.getDisplayName(systemID);
+				statistics.systems[systemID].entityCount = m_systems[systemID]->entities.size();
+			}
+		}
+
+		void entityDestroyed(Entity entity, ComponentMask entityComponents) {
+			recordComponentEvents(m_removedEntities, entity, entityComponents);
+
+			for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				if (!entityComponents[i]) {
+					continue;
+				}
+
+				for (uint32_t systemID : m_componentSystems[i]) {
+					m_systems[systemID]->onEntityComponentRemoved(entity, i);
+				}
+			}
+
+			for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				if (!entityComponents[i]) {
+					continue;
+				}
+
+				for (uint32_t systemID : m_componentSystems[i]) {
+					m_systems[systemID]->entities.erase(entity);
+				}
+			}
+		}
+
+		// The Entities had no Components before
+		void entitiesCreated(const std::vector<Entity>& entities, ComponentMask entityComponents) {
+			const ComponentMask observedEntityComponents = entityComponents & m_observedComponents;
+			if (observedEntityComponents.any()) {
+				for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+					if (observedEntityComponents[i]) {
+						m_addedEntities[i].insert(m_addedEntities[i].end(), entities.begin(), entities.end());
+					}
+				}
+			}
+
+			for (size_t systemID = 0; systemID < m_systems.size(); systemID++) {
+				System* system = m_systems[systemID];
+				const ComponentMask entityAndSystemComponentMask = entityComponents & m_componentMasks[systemID];
+				if (entityAndSystemComponentMask.none()) {
+					continue;
+				}
+
+				for (Entity entity : entities) {
+					system->entities.insert(entity);
+				}
+
+				for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+					if (entityAndSystemComponentMask[i]) {
+						system->onEntitiesComponentAdded(entities, i);
+					}
+				}
+			}
+		}
+
+		void entitiesDestroyed(const std::vector<Entity>& entities, const std::vector<ComponentMask>& entitiesComponents) {
+			if (m_observedComponents.any()) {
+				for (size_t j = 0; j < entities.size(); j++) {
+					recordComponentEvents(m_removedEntities, entities[j], entitiesComponents[j]);
+				}
+			}
+
+			std::vector<Entity> entitiesInSystem;
+			for (size_t systemID = 0; systemID < m_systems.size(); systemID++) {
+				System* system = m_systems[systemID];
+				const ComponentMask systemComponentMask = m_componentMasks[systemID];
+
+				for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+					if (!systemComponentMask[i]) {
+						continue;
+					}
+
+					entitiesInSystem.clear();
+					for (size_t j = 0; j < entities.size(); j++) {
+						if (entitiesComponents[j][i]) {
+							entitiesInSystem.push_back(entities[j]);
+						}
+					}
+
+					if (!entitiesInSystem.empty()) {
+						system->onEntitiesComponentRemoved(entitiesInSystem, i);
+					}
+				}
+
+				for (size_t j = 0; j < entities.size(); j++) {
+					if ((entitiesComponents[j] & systemComponentMask).any()) {
+						system->entities.erase(entities[j]);
+					}
+				}
+			}
+		}
+
+		void entityComponentMaskChanged(Entity entity, ComponentMask oldEntityComponentMask, ComponentMask newEntityComponentMask, Component componentID) {
+			const bool componentAdded = newEntityComponentMask[componentID] && !oldEntityComponentMask[componentID];
+			const bool componentRemoved = !newEntityComponentMask[componentID] && oldEntityComponentMask[componentID];
+			if (m_observedComponents[componentID]) {
+				if (componentAdded) {
+					m_addedEntities[componentID].push_back(entity);
+				}
+				else if (componentRemoved) {
+					m_removedEntities[componentID].push_back(entity);
+				}
+			}
+
+			// Only the Systems using this Component are concerned
+			for (uint32_t systemID : m_componentSystems[componentID]) {
+				System* system = m_systems[systemID];
+				const ComponentMask systemComponentMask = m_componentMasks[systemID];
+				if (componentAdded) {
+					system->onEntityComponentAdded(entity, componentID);
+					if ((oldEntityComponentMask & systemComponentMask).none()) { // The entity is new in the system
+						system->entities.insert(entity);
+					}
+				}
+				else if (componentRemoved) {
+					system->onEntityComponentRemoved(entity, componentID);
+					if ((newEntityComponentMask & systemComponentMask).none()) { // The entity has no more component for the system
+						system->entities.erase(entity);
+					}
+				}
+			}
+		}
+
+	private:
+		void recordComponentEvents(std::array<std::vector<Entity>, NTSHENGN_MAX_COMPONENTS>& componentEntities, Entity entity, ComponentMask entityComponents) {
+			const ComponentMask observedEntityComponents = entityComponents & m_observedComponents;
+			if (observedEntityComponents.none()) {
+				return;
+			}
+
+			for (uint8_t i = 0; i < NTSHENGN_MAX_COMPONENTS; i++) {
+				if (observedEntityComponents[i]) {
+					componentEntities[i].push_back(entity);
+				}
+			}
+		}
+
+		void runSystem(uint32_t systemID, const std::function<void(System*)>& function) {
+#if defined(NTSHENGN_DEBUG)
+			runningSystemWriteComponentMask() = &m_writeComponentMasks[systemID];
+#endif
+			function(m_systems[systemID]);
+#if defined(NTSHENGN_DEBUG)
+			runningSystemWriteComponentMask() = nullptr;
+#endif
+		}
+
+		bool accessesConflict(size_t firstSystemID, size_t secondSystemID) const {
+			return (m_writeComponentMasks[firstSystemID] & (m_readComponentMasks[secondSystemID] | m_writeComponentMasks[secondSystemID])).any() ||
+				(m_writeComponentMasks[secondSystemID] & m_readComponentMasks[firstSystemID]).any();
+		}
+
+		// A System depends on every System registered before it with a conflicting access
+		// Each System is put in the stage following the last stage of its dependencies
+		void buildSchedule() {
+			std::vector<uint32_t> systemStages(m_systems.size(), 0);
+			uint32_t stageCount = 0;
+			for (size_t systemID = 0; systemID < m_systems.size(); systemID++) {
+				if (m_internalSystems[systemID]) {
+					continue;
+				}
+
+				for (size_t previousSystemID = 0; previousSystemID < systemID; previousSystemID++) {
+					if (!m_internalSystems[previousSystemID] && (systemStages[previousSystemID] >= systemStages[systemID]) && accessesConflict(previousSystemID, systemID)) {
+						systemStages[systemID] = systemStages[previousSystemID] + 1;
+					}
+				}
+				stageCount = std::max(stageCount, systemStages[systemID] + 1);
+			}
+
+			m_scheduleStages.assign(stageCount, std::vector<uint32_t>());
+			for (size_t systemID = 0; systemID < m_systems.size(); systemID++) {
+				if (m_internalSystems[systemID]) {
+					continue;
+				}
+
+				m_scheduleStages[systemStages[systemID]].push_back(static_cast<uint32_t>(systemID));
+			}
+			m_scheduleOutdated = false;
+		}
+
+	private:
+		TypeIDRegistry m_systemTypes;
+		std::vector<System*> m_systems;
+		std::vector<ComponentMask> m_componentMasks;
+		std::array<std::vector<uint32_t>, NTSHENGN_MAX_COMPONENTS> m_componentSystems; // Systems using each Component, sorted by System ID
+
+		std::vector<ComponentMask> m_readComponentMasks;
+		std::vector<ComponentMask> m_writeComponentMasks;
+		std::vector<bool> m_internalSystems;
+		std::vector<std::vector<uint32_t>> m_scheduleStages;
+		bool m_scheduleOutdated = true;
+
+		// Observers and pending events, indexed by Component ID
+		std::array<std::vector<ComponentObserver*>, NTSHENGN_MAX_COMPONENTS> m_observers;
+		ComponentMask m_observedComponents;
+		std::array<std::vector<Entity>, NTSHENGN_MAX_COMPONENTS> m_addedEntities;
+		std::array<std::vector<Entity>, NTSHENGN_MAX_COMPONENTS> m_removedEntities;
+		std::vector<Entity> m_deliveredEntities;
+	};
+
+	// Computes the world matrix of every Entity having a Transform, following Parent Components
+	// Entities are stored sorted by depth, so that parents are always computed before their children
+	// Only the subtrees of changed Transforms are recomputed, the order is rebuilt when the hierarchy changes
+	class TransformHierarchy : public System {
+	public:
+		void onEntityComponentAdded(Entity entity, Component componentID) {
+			NTSHENGN_UNUSED(entity);
+			NTSHENGN_UNUSED(componentID);
+
+			m_hierarchyOutdated = true;
+		}
+
+		void onEntityComponentRemoved(Entity entity, Component componentID) {
+			NTSHENGN_UNUSED(entity);
+			NTSHENGN_UNUSED(componentID);
+
+			m_hierarchyOutdated = true;
+		}
+
+		void update(ComponentManager& componentManager) {
+			const std::vector<Entity> changedParentEntities = componentManager.changed<Parent>(m_lastParentChangeTick);
+			const std::vector<Entity> changedTransformEntities = componentManager.changed<Transform>(m_lastTransformChangeTick);
+			if (m_hierarchyOutdated || !changedParentEntities.empty()) {
+				buildHierarchy(componentManager);
+			}
+			else {
+				for (Entity entity : changedTransformEntities) {
+					const uint32_t entityIndex = getEntityIndex(entity);
+					if ((entityIndex < m_entitySlots.size()) && (m_entitySlots[entityIndex] != NTSHENGN_ENTITY_UNKNOWN)) {
+						m_dirty[m_entitySlots[entityIndex]] = true;
+					}
+				}
+			}
+
+			for (size_t slot = 0; slot < m_entities.size(); slot++) {
+				const uint32_t parentSlot = m_parentSlots[slot];
+				if ((parentSlot != NTSHENGN_ENTITY_UNKNOWN) && m_dirty[parentSlot]) {
+					m_dirty[slot] = true;
+				}
+
+				if (!m_dirty[slot]) {
+					continue;
+				}
+
+				const Transform& transform = componentManager.readComponent<Transform>(m_entities[slot]);
+				const Math::mat4 localMatrix = Math::translate(transform.position) * Math::quatToRotationMatrix(transform.rotation) * Math::scale(transform.scale);
+				m_worldMatrices[slot] = (parentSlot != NTSHENGN_ENTITY_UNKNOWN) ? (m_worldMatrices[parentSlot] * localMatrix) : localMatrix;
+			}
+			std::fill(m_dirty.begin(), m_dirty.end(), false);
+		}
+
+		const Math::mat4& getWorldMatrix(Entity entity) const {
+			const uint32_t entityIndex = getEntityIndex(entity);
+
+			NTSHENGN_ASSERT((entityIndex < m_entitySlots.size()) && (m_entitySlots[entityIndex] != NTSHENGN_ENTITY_UNKNOWN) && (m_entities[m_entitySlots[entityIndex]] == entity), "Entity " + std::to_string(entity) + " has no world matrix.");
+
+			return m_worldMatrices[m_entitySlots[entityIndex]];
+		}
+
+	private:
+		void buildHierarchy(ComponentManager& componentManager) {
+			// Parent of each Entity having a Transform, Entities whose parent has no Transform are roots
+			std::vector<Entity> transformEntities;
+			transformEntities.reserve(entities.size());
+			for (Entity entity : entities) {
+				if (componentManager.hasComponent<Transform>(entity)) {
+					transformEntities.push_back(entity);
+				}
+			}
+
+			m_entitySlots.clear();
+			for (Entity entity : transformEntities) {
+				const uint32_t entityIndex = getEntityIndex(entity);
+				if (entityIndex >= m_entitySlots.size()) {
+					m_entitySlots.resize(entityIndex + 1, NTSHENGN_ENTITY_UNKNOWN);
+				}
+			}
+
+			std::vector<Entity> parents(transformEntities.size(), NTSHENGN_ENTITY_UNKNOWN);
+			for (size_t i = 0; i < transformEntities.size(); i++) {
+				m_entitySlots[getEntityIndex(transformEntities[i])] = static_cast<uint32_t>(i);
+			}
+			for (size_t i = 0; i < transformEntities.size(); i++) {
+				if (!componentManager.hasComponent<Parent>(transformEntities[i])) {
+					continue;
+				}
+
+				const Entity parent = componentManager.readComponent<Parent>(transformEntities[i]).entity;
+				const uint32_t parentIndex = getEntityIndex(parent);
+				if ((parent != NTSHENGN_ENTITY_UNKNOWN) && (parentIndex < m_entitySlots.size()) && (m_entitySlots[parentIndex] != NTSHENGN_ENTITY_UNKNOWN) && (transformEntities[m_entitySlots[parentIndex]] == parent)) {
+					parents[i] = parent;
+				}
+			}
+
+			// Depth of each Entity, the number of ancestors
+			std::vector<uint32_t> depths(transformEntities.size(), NTSHENGN_ENTITY_UNKNOWN);
+			std::vector<uint32_t> ancestors;
+			for (size_t i = 0; i < transformEntities.size(); i++) {
+				uint32_t slot = static_cast<uint32_t>(i);
+				ancestors.clear();
+				while ((depths[slot] == NTSHENGN_ENTITY_UNKNOWN) && (parents[slot] != NTSHENGN_ENTITY_UNKNOWN)) {
+					if (ancestors.size() == transformEntities.size()) {
+						NTSHENGN_ASSERT(false, "Entity " + std::to_string(transformEntities[i]) + " is its own ancestor.");
+
+						// Break the cycle by making the Entity a root
+						parents[i] = NTSHENGN_ENTITY_UNKNOWN;
+						ancestors.clear();
+						slot = static_cast<uint32_t>(i);
+						break;
+					}
+
+					ancestors.push_back(slot);
+					slot = m_entitySlots[getEntityIndex(parents[slot])];
+				}
+
+				uint32_t depth = (depths[slot] == NTSHENGN_ENTITY_UNKNOWN) ? 0 : depths[slot];
+				depths[slot] = depth;
+				for (auto it = ancestors.rbegin(); it != ancestors.rend(); it++) {
+					depths[*it] = ++depth;
+				}
+			}
+
+			std::vector<uint32_t> sortedSlots(transformEntities.size());
+			for (size_t i = 0; i < sortedSlots.size(); i++) {
+				sortedSlots[i] = static_cast<uint32_t>(i);
+			}
+			std::stable_sort(sortedSlots.begin(), sortedSlots.end(), [&depths](uint32_t a, uint32_t b) {
+				return depths[a] < depths[b];
+			});
+
+			m_entities.resize(transformEntities.size());
+			for (size_t slot = 0; slot < sortedSlots.size(); slot++) {
+				m_entities[slot] = transformEntities[sortedSlots[slot]];
+				m_entitySlots[getEntityIndex(m_entities[slot])] = static_cast<uint32_t>(slot);
+			}
+
+			m_parentSlots.resize(m_entities.size());
+			for (size_t slot = 0; slot < sortedSlots.size(); slot++) {
+				const Entity parent = parents[sortedSlots[slot]];
+				m_parentSlots[slot] = (parent != NTSHENGN_ENTITY_UNKNOWN) ? m_entitySlots[getEntityIndex(parent)] : NTSHENGN_ENTITY_UNKNOWN;
+			}
+
+			m_worldMatrices.resize(m_entities.size());
+			m_dirty.assign(m_entities.size(), true);
+			m_hierarchyOutdated = false;
+		}
+
+	private:
+		// Depth-sorted Entities and their parent slots, world matrices and dirty flags
+		std::vector<Entity> m_entities;
+		std::vector<uint32_t> m_parentSlots;
+		std::vector<Math::mat4> m_worldMatrices;
+		std::vector<bool> m_dirty;
+
+		// Slot of each Entity, indexed by Entity index
+		std::vector<uint32_t> m_entitySlots;
+
+		bool m_hierarchyOutdated = true;
+		uint32_t m_lastParentChangeTick = 0;
+		uint32_t m_lastTransformChangeTick = 0;
+	};
+
+	class ECSCommandBuffer;
+
+	class ECSInterface {
+	public:
+		virtual void init() = 0;
+
+		// Entity
+		virtual Entity createEntity() = 0;
+		virtual Entity createEntity(std::string_view name) = 0;
+
+		// Creates count Entities, each having a copy of the prototype Components
+		template <typename... Components>
+		std::vector<Entity> createEntities(uint32_t count, const Components&... components) {
+			std::vector<Entity> entities = m_entityManager->createEntities(count);
+			if constexpr (sizeof...(Components) != 0) {
+				ComponentMask componentMask;
+				(componentMask.set(m_componentManager->getComponentID<Components>()), ...);
+
+				m_componentManager->addComponents(entities, components...);
+				for (Entity entity : entities) {
+					m_entityManager->setComponents(entity, componentMask);
+				}
+				m_systemManager->entitiesCreated(entities, componentMask);
+			}
+
+			return entities;
+		}
+
+		virtual void destroyEntity(Entity entity) = 0;
+		virtual void destroyEntities(const std::vector<Entity>& entities) = 0;
+		virtual void destroyAllEntities() = 0;
+		virtual void destroyNonPersistentEntities() = 0;
+
+		virtual bool entityExists(Entity entity) = 0;
+
+		virtual const EntitySet& getEntities() = 0;
+
+		// Returns false if another Entity already has this name
+		virtual bool setEntityName(Entity entity, std::string_view name) = 0;
+		virtual bool entityHasName(Entity entity) = 0;
+		virtual const std::string& getEntityName(Entity entity) = 0;
+		virtual Entity findEntityByName(std::string_view name) = 0;
+		virtual NameID getEntityNameID(Entity entity) = 0;
+		virtual Entity findEntityByNameID(NameID nameID) = 0;
+
+		virtual void setEntityPersistence(Entity entity, bool persistent) = 0;
+		virtual bool isEntityPersistent(Entity entity) = 0;
+
+		virtual void addEntityToEntityGroup(Entity entity, std::string_view entityGroupName) = 0;
+		virtual void removeEntityFromEntityGroup(Entity entity, std::string_view entityGroupName) = 0;
+
+		virtual bool entityGroupExists(std::string_view entityGroupName) = 0;
+
+		virtual bool isEntityInEntityGroup(Entity entity, std::string_view entityGroupName) = 0;
+		virtual bool isEntityInEntityGroup(Entity entity, EntityGroupID entityGroupID) = 0;
+		virtual const EntitySet& getEntitiesInEntityGroup(std::string_view entityGroupName) = 0;
+		virtual const EntitySet& getEntitiesInEntityGroup(EntityGroupID entityGroupID) = 0;
+		virtual const std::vector<EntityGroupID>& getEntityGroupsOfEntity(Entity entity) = 0;
+
+		virtual EntityGroupID getEntityGroupID(std::string_view entityGroupName) = 0;
+		virtual const std::string& getEntityGroupName(EntityGroupID entityGroupID) = 0;
+
+		// Entities in both Entity groups
+		EntitySet getEntityGroupsIntersection(EntityGroupID firstEntityGroupID, EntityGroupID secondEntityGroupID) {
+			return getEntitiesInEntityGroup(firstEntityGroupID).getIntersection(getEntitiesInEntityGroup(secondEntityGroupID));
+		}
+
+		// Entities in any of the Entity groups
+		EntitySet getEntityGroupsUnion(EntityGroupID firstEntityGroupID, EntityGroupID secondEntityGroupID) {
+			return getEntitiesInEntityGroup(firstEntityGroupID).getUnion(getEntitiesInEntityGroup(secondEntityGroupID));
+		}
+
+		// Component
+		template <typename T>
+		void registerComponent() {
+			return m_componentManager->registerComponent<T>();
+		}
+
+		template <typename T>
+		void addComponent(Entity entity, T component) {
+			emplaceComponent<T>(entity, std::move(component));
+		}
+
+		// Constructs the Component in place with args, without any temporary Component
+		// The returned reference is invalidated by the next structural change, including those made by Systems notified of this addition
+		template <typename T, typename... Args>
+		T& emplaceComponent(Entity entity, Args&&... args) {
+			T& component = m_componentManager->emplaceComponent<T>(entity, std::forward<Args>(args)...);
+			ComponentMask oldComponents = m_entityManager->getComponents(entity);
+			ComponentMask newComponents = oldComponents;
+			Component componentID = m_componentManager->getComponentID<T>();
+			newComponents.set(componentID, true);
+			m_entityManager->setComponents(entity, newComponents);
+			m_systemManager->entityComponentMaskChanged(entity, oldComponents, newComponents, componentID);
+
+			return component;
+		}
+
+		template <typename T>
+		void removeComponent(Entity entity) {
+			ComponentMask oldComponents = m_entityManager->getComponents(entity);
+			ComponentMask newComponents = oldComponents;
+			Component componentID = m_componentManager->getComponentID<T>();
+			newComponents.set(componentID, false);
+			m_entityManager->setComponents(entity, newComponents);
+			m_systemManager->entityComponentMaskChanged(entity, oldComponents, newComponents, componentID);
+			m_componentManager->removeComponent<T>(entity);
+		}
+
+		template <typename T>
+		bool hasComponent(Entity entity) {
+			return m_componentManager->hasComponent<T>(entity);
+		}
+
+		// Marks the Component as changed, use readComponent to only read it
+		template <typename T>
+		T& getComponent(Entity entity) {
+			return m_componentManager->getComponent<T>(entity);
+		}
+
+		template <typename T>
+		const T& readComponent(Entity entity) {
+			return m_componentManager->readComponent<T>(entity);
+		}
+
+		// Returns the Entities having the Component T changed since the last call with the same lastChangeTick, starting at 0
+		template <typename T>
+		std::vector<Entity> changed(uint32_t& lastChangeTick) {
+			return m_componentManager->changed<T>(lastChangeTick);
+		}
+
+		template <typename T>
+		Component getComponentID() {
+			return m_componentManager->getComponentID<T>();
+		}
+
+		// Iterates over every Entity having all the Components
+		// for (auto [entity, transform, rigidbody] : ecs->view<Transform, Rigidbody>()) { ... }
+		template <typename... Components>
+		ComponentView<Components...> view() {
+			return m_componentManager->view<Components...>();
+		}
+
+		// Calls function(entity, components...) for every Entity having all the Components
+		template <typename... Components, typename Function>
+		void forEach(Function&& function) {
+			m_componentManager->view<Components...>().each(std::forward<Function>(function));
+		}
+
+		// Calls function(entity, components...) for every Entity having all the Components, split in jobs of grainSize Entities dispatched on the job system
+		// function is called concurrently and must not add or remove Components nor create or destroy Entities, use an ECSCommandBuffer instead
+		template <typename... Components, typename Function>
+		void parallelForEach(JobSystemInterface* jobSystem, uint32_t grainSize, Function&& function) {
+			NTSHENGN_ASSERT(grainSize != 0, "grainSize must be greater than 0.");
+
+			ComponentView<Components...> componentView = m_componentManager->view<Components...>();
+			const size_t rangeSize = componentView.getRangeSize();
+			if (rangeSize == 0) {
+				return;
+			}
+
+			// Called from a job of runSystems or of another parallelForEach, the job system cannot be waited on, so the range is run inline
+			const uint32_t jobCount = static_cast<uint32_t>((rangeSize + grainSize - 1) / grainSize);
+			if ((jobCount == 1) || !jobSystem || runningECSJob()) {
+				componentView.each(function);
+
+				return;
+			}
+
+			jobSystem->dispatch(jobCount, 1, [&componentView, &function, rangeSize, grainSize](JobDispatchArguments args) {
+				const size_t rangeBegin = static_cast<size_t>(args.jobIndex) * grainSize;
+				runningECSJob() = true;
+				componentView.eachInRange(rangeBegin, std::min(rangeBegin + grainSize, rangeSize), function);
+				runningECSJob() = false;
+			});
+			jobSystem->wait();
+		}
+
+		ComponentStorageType getComponentStorageType() {
+			return m_componentManager->getStorageType();
 		}
 
 		// System
@@ -499,10 +2988,407 @@ namespace NtshEngn {
 			m_systemManager->setComponents<T>(componentMask);
 		}
 
+		// Declares the Components read and written by the System, used to run Systems concurrently in runSystems
+		// This is the only way to declare them, Systems without a declared access write all Components and never run concurrently with other Systems
+		// Change ticks are shared, so a System must access the Components it only reads with readComponent or as const Components in views
+		// getComponent and mutable views mark the Component as changed, which is a write (asserted in debug builds)
+		template <typename T>
+		void setSystemComponentAccess(ComponentMask readComponentMask, ComponentMask writeComponentMask) {
+			m_systemManager->setComponentAccess<T>(readComponentMask, writeComponentMask);
+		}
+
+		// Systems run concurrently must record their structural changes in an ECSCommandBuffer, see SystemManager::runSystems
+		void runSystems(JobSystemInterface* jobSystem, const std::function<void(System*)>& function) {
+			m_systemManager->runSystems(jobSystem, function);
+		}
+
+		// Snapshot
+		// Saves the Entities with their names, groups and persistence, and their SnapshotComponents
+		// skippedComponents receives the Components that some Entities have but that are not SnapshotComponents, restored Entities do not have them
+		Buffer saveSnapshot(ComponentMask& skippedComponents) {
+			Buffer snapshot;
+			writeSnapshotValue<uint32_t>(snapshot, NTSHENGN_ECS_SNAPSHOT_MAGIC);
+			writeSnapshotValue<uint32_t>(snapshot, NTSHENGN_ECS_SNAPSHOT_VERSION);
+			m_entityManager->writeSnapshot(snapshot);
+			m_componentManager->writeSnapshot(snapshot, skippedComponents);
+
+			return snapshot;
+		}
+
+		Buffer saveSnapshot() {
+			ComponentMask skippedComponents;
+
+			return saveSnapshot(skippedComponents);
+		}
+
+		// Destroys every Entity, persistent Entities included, and replaces them with the ones of the snapshot
+		// Systems are notified of the destroyed Components, then of the restored ones
+		void loadSnapshot(Buffer& snapshot) {
+			snapshot.setCursorPosition(0);
+			const uint32_t magic = readSnapshotValue<uint32_t>(snapshot);
+			const uint32_t version = readSnapshotValue<uint32_t>(snapshot);
+
+			NTSHENGN_ASSERT((magic == NTSHENGN_ECS_SNAPSHOT_MAGIC) && (version == NTSHENGN_ECS_SNAPSHOT_VERSION), "Buffer is not an ECS snapshot of this version.");
+			NTSHENGN_UNUSED(magic);
+			NTSHENGN_UNUSED(version);
+
+			destroyAllEntities();
+			m_entityManager->readSnapshot(snapshot);
+			std::vector<ComponentMask> entityComponentMasks;
+			m_componentManager->readSnapshot(snapshot, entityComponentMasks);
+
+			std::unordered_map<unsigned long, std::vector<Entity>> entitiesByComponentMask;
+			for (Entity entity : m_entityManager->getExistingEntities()) {
+				const uint32_t entityIndex = getEntityIndex(entity);
+				if (entityIndex >= entityComponentMasks.size()) {
+					continue;
+				}
+
+				const ComponentMask componentMask = entityComponentMasks[entityIndex];
+				m_entityManager->setComponents(entity, componentMask);
+				if (componentMask.any()) {
+					entitiesByComponentMask[componentMask.to_ulong()].push_back(entity);
+				}
+			}
+			for (const std::pair<const unsigned long, std::vector<Entity>>& entitiesWithComponentMask : entitiesByComponentMask) {
+				m_systemManager->entitiesCreated(entitiesWithComponentMask.second, ComponentMask(entitiesWithComponentMask.first));
+			}
+		}
+
+		// Observers
+		// The observer receives the Entities that got or lost the Component T on each notifyObservers
+		template <typename T>
+		void registerObserver(ComponentObserver* observer) {
+			m_systemManager->registerObserver(observer, m_componentManager->getComponentID<T>());
+		}
+
+		template <typename T>
+		void unregisterObserver(ComponentObserver* observer) {
+			m_systemManager->unregisterObserver(observer, m_componentManager->getComponentID<T>());
+		}
+
+		// Delivers the Component events recorded since the last call, meant to be called once per frame
+		void notifyObservers() {
+			m_systemManager->notifyObservers();
+		}
+
+		// Statistics
+		ECSStatistics getStatistics() const {
+			ECSStatistics statistics;
+			m_entityManager->getStatistics(statistics);
+			m_componentManager->getStatistics(statistics);
+			m_systemManager->getStatistics(statistics);
+
+			return statistics;
+		}
+
+		// Sets the statistics as "ECS/..." counters of the running profiler session
+		void exportStatistics(ProfilerInterface* profiler) const {
+			const ECSStatistics statistics = getStatistics();
+			profiler->setCounter("ECS/Entities", static_cast<double>(statistics.entityCount));
+			profiler->setCounter("ECS/EntityIndices", static_cast<double>(statistics.entityIndexCount));
+			profiler->setCounter("ECS/AvailableEntityIndices", static_cast<double>(statistics.availableEntityIndexCount));
+			profiler->setCounter("ECS/MaxEntities", static_cast<double>(statistics.maxEntities));
+			profiler->setCounter("ECS/EntityBytes", static_cast<double>(statistics.entityBytes));
+			profiler->setCounter("ECS/Archetypes", static_cast<double>(statistics.archetypeCount));
+			profiler->setCounter("ECS/ArchetypeBytes", static_cast<double>(statistics.archetypeBytes));
+			for (const ComponentStatistics& componentStatistics : statistics.components) {
+				const std::string counterPrefix = "ECS/Components/" + componentStatistics.name + "/";
+				profiler->setCounter(counterPrefix + "Count", static_cast<double>(componentStatistics.count));
+				profiler->setCounter(counterPrefix + "Capacity", static_cast<double>(componentStatistics.capacity));
+				profiler->setCounter(counterPrefix + "Bytes", static_cast<double>(componentStatistics.bytes));
+				profiler->setCounter(counterPrefix + "Fragmentation", componentStatistics.fragmentation);
+			}
+			for (const SystemStatistics& systemStatistics : statistics.systems) {
+				profiler->setCounter("ECS/Systems/" + systemStatistics.name + "/Entities", static_cast<double>(systemStatistics.entityCount));
+			}
+		}
+
+		// Transform hierarchy
+		// Registers the Parent Component and the TransformHierarchy System, Transform must already be registered
+		// TransformHierarchy is internal, it is not run by runSystems but by updateWorldMatrices
+		void registerTransformHierarchy() {
+			registerComponent<Parent>();
+			m_systemManager->registerInternalSystem<TransformHierarchy>(&m_transformHierarchy);
+
+			ComponentMask componentMask;
+			componentMask.set(getComponentID<Transform>());
+			componentMask.set(getComponentID<Parent>());
+			setSystemComponents<TransformHierarchy>(componentMask);
+			// World matrices are kept in the System, Transforms and Parents are only read
+			setSystemComponentAccess<TransformHierarchy>(componentMask, ComponentMask());
+		}
+
+		// Recomputes the world matrices of the changed Transforms and their children
+		void updateWorldMatrices() {
+			m_transformHierarchy.update(*m_componentManager);
+		}
+
+		// Returns the world matrix of the Entity computed during the last updateWorldMatrices
+		const Math::mat4& getWorldMatrix(Entity entity) const {
+			return m_transformHierarchy.getWorldMatrix(entity);
+		}
+
+		// Command buffers
+		// Returns the ECSCommandBuffer of the calling thread
+		ECSCommandBuffer& getCommandBuffer();
+
+		// Applies and clears every ECSCommandBuffer, must not be called while other threads are recording commands
+		// Commands recorded during playback (by System callbacks for example) are applied by the next playback
+		void playbackCommandBuffers();
+
 	protected:
 		std::unique_ptr<EntityManager> m_entityManager;
 		std::unique_ptr<ComponentManager> m_componentManager;
 		std::unique_ptr<SystemManager> m_systemManager;
+
+	private:
+		TransformHierarchy m_transformHierarchy;
+
+		std::vector<std::pair<std::thread::id, std::unique_ptr<ECSCommandBuffer>>> m_commandBuffers;
+		std::vector<std::unique_ptr<ECSCommandBuffer>> m_playbackCommandBuffers;
+		std::mutex m_commandBuffersMutex;
+	};
+
+	// Records structural changes (Entity creation and destruction, Component addition and removal) to apply them later with ECSInterface::playbackCommandBuffers
+	// Each thread records in its own ECSCommandBuffer, obtained with ECSInterface::getCommandBuffer
+	class ECSCommandBuffer {
+	public:
+		enum class CommandType {
+			DestroyEntity,
+			AddComponent,
+			RemoveComponent
+		};
+
+		struct Command {
+			CommandType type;
+			Entity entity;
+			void* component = nullptr;
+			void (*apply)(ECSInterface& ecs, Entity entity, void* component) = nullptr;
+			void (*destruct)(void* component) = nullptr;
+		};
+
+	public:
+		ECSCommandBuffer() = default;
+		ECSCommandBuffer(const ECSCommandBuffer&) = delete;
+		ECSCommandBuffer& operator=(const ECSCommandBuffer&) = delete;
+		~ECSCommandBuffer() {
+			clear();
+		}
+
+		// Returns a deferred Entity, only valid in this ECSCommandBuffer, replaced by a real Entity during playback
+		Entity createEntity() {
+			NTSHENGN_ASSERT(m_createdEntityCount < NTSHENGN_ENTITY_INDEX_MASK, "Too many Entities created in an ECSCommandBuffer.");
+
+			return makeEntity(m_createdEntityCount++, NTSHENGN_ENTITY_GENERATION_DEFERRED);
+		}
+
+		void destroyEntity(Entity entity) {
+			NTSHENGN_ASSERT(entity != NTSHENGN_ENTITY_UNKNOWN, "Cannot record a command on NTSHENGN_ENTITY_UNKNOWN.");
+
+			Command command;
+			command.type = CommandType::DestroyEntity;
+			command.entity = entity;
+			m_commands.push_back(command);
+		}
+
+		// If the Entity already has the Component during playback, its value is replaced
+		template <typename T>
+		void addComponent(Entity entity, T component) {
+			NTSHENGN_ASSERT(entity != NTSHENGN_ENTITY_UNKNOWN, "Cannot record a command on NTSHENGN_ENTITY_UNKNOWN.");
+
+			Command command;
+			command.type = CommandType::AddComponent;
+			command.entity = entity;
+			command.component = new (allocate(sizeof(T), alignof(T))) T(std::move(component));
+			command.apply = [](ECSInterface& ecs, Entity commandEntity, void* commandComponent) {
+				T& componentToAdd = *std::launder(static_cast<T*>(commandComponent));
+				if (ecs.hasComponent<T>(commandEntity)) {
+					ecs.getComponent<T>(commandEntity) = std::move(componentToAdd);
+				}
+				else {
+					ecs.addComponent<T>(commandEntity, std::move(componentToAdd));
+				}
+			};
+			command.destruct = [](void* commandComponent) {
+				std::launder(static_cast<T*>(commandComponent))->~T();
+			};
+			m_commands.push_back(command);
+		}
+
+		// Ignored during playback if the Entity does not have the Component
+		template <typename T>
+		void removeComponent(Entity entity) {
+			NTSHENGN_ASSERT(entity != NTSHENGN_ENTITY_UNKNOWN, "Cannot record a command on NTSHENGN_ENTITY_UNKNOWN.");
+
+			Command command;
+			command.type = CommandType::RemoveComponent;
+			command.entity = entity;
+			command.apply = [](ECSInterface& ecs, Entity commandEntity, void* commandComponent) {
+				NTSHENGN_UNUSED(commandComponent);
+				if (ecs.hasComponent<T>(commandEntity)) {
+					ecs.removeComponent<T>(commandEntity);
+				}
+			};
+			m_commands.push_back(command);
+		}
+
+		const std::vector<Command>& getCommands() const {
+			return m_commands;
+		}
+
+		uint32_t getCreatedEntityCount() const {
+			return m_createdEntityCount;
+		}
+
+		bool empty() const {
+			return m_commands.empty() && (m_createdEntityCount == 0);
+		}
+
+		void swap(ECSCommandBuffer& other) {
+			std::swap(m_commands, other.m_commands);
+			std::swap(m_createdEntityCount, other.m_createdEntityCount);
+			std::swap(m_blocks, other.m_blocks);
+			std::swap(m_blockSizes, other.m_blockSizes);
+			std::swap(m_blockOffset, other.m_blockOffset);
+		}
+
+		void clear() {
+			for (Command& command : m_commands) {
+				if (command.destruct) {
+					command.destruct(command.component);
+				}
+			}
+			m_commands.clear();
+			m_createdEntityCount = 0;
+
+			// Keep the first block for the next frame
+			if (m_blocks.size() > 1) {
+				m_blocks.resize(1);
+				m_blockSizes.resize(1);
+			}
+			m_blockOffset = 0;
+		}
+
+	private:
+		// Components are stored in blocks that are never moved, as Components are not always trivially relocatable
+		void* allocate(size_t size, size_t alignment) {
+			NTSHENGN_ASSERT(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Component alignment is too large for ECSCommandBuffer.");
+
+			m_blockOffset = ((m_blockOffset + alignment - 1) / alignment) * alignment;
+			if (m_blocks.empty() || ((m_blockOffset + size) > m_blockSizes.back())) {
+				const size_t blockSize = std::max(static_cast<size_t>(NTSHENGN_COMMAND_BUFFER_BLOCK_SIZE), size);
+				m_blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+				m_blockSizes.push_back(blockSize);
+				m_blockOffset = 0;
+			}
+
+			void* data = m_blocks.back().get() + m_blockOffset;
+			m_blockOffset += size;
+
+			return data;
+		}
+
+	private:
+		std::vector<Command> m_commands;
+		uint32_t m_createdEntityCount = 0;
+
+		std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+		std::vector<size_t> m_blockSizes;
+		size_t m_blockOffset = 0;
 	};
 
+	inline ECSCommandBuffer& ECSInterface::getCommandBuffer() {
+		std::unique_lock<std::mutex> lock(m_commandBuffersMutex);
+
+		const std::thread::id threadID = std::this_thread::get_id();
+		for (std::pair<std::thread::id, std::unique_ptr<ECSCommandBuffer>>& commandBuffer : m_commandBuffers) {
+			if (commandBuffer.first == threadID) {
+				return *commandBuffer.second;
+			}
+		}
+
+		m_commandBuffers.push_back({ threadID, std::make_unique<ECSCommandBuffer>() });
+
+		return *m_commandBuffers.back().second;
+	}
+
+	inline void ECSInterface::playbackCommandBuffers() {
+		// The recorded commands are moved out under the lock and applied without it, as callbacks triggered by the playback can call getCommandBuffer
+		{
+			std::unique_lock<std::mutex> lock(m_commandBuffersMutex);
+
+			while (m_playbackCommandBuffers.size() < m_commandBuffers.size()) {
+				m_playbackCommandBuffers.push_back(std::make_unique<ECSCommandBuffer>());
+			}
+			for (size_t i = 0; i < m_commandBuffers.size(); i++) {
+				m_playbackCommandBuffers[i]->swap(*m_commandBuffers[i].second);
+			}
+		}
+
+		// Deferred Entities of all ECSCommandBuffers are created in a single batch
+		uint32_t createdEntityCount = 0;
+		for (const std::unique_ptr<ECSCommandBuffer>& commandBuffer : m_playbackCommandBuffers) {
+			createdEntityCount += commandBuffer->getCreatedEntityCount();
+		}
+		const std::vector<Entity> createdEntities = createEntities(createdEntityCount);
+
+		struct PendingCommand {
+			Entity entity;
+			size_t order;
+			const ECSCommandBuffer::Command* command;
+		};
+
+		std::vector<PendingCommand> pendingCommands;
+		std::vector<Entity> destroyedEntities;
+		EntitySet destroyedEntitySet;
+		size_t createdEntityOffset = 0;
+		size_t order = 0;
+		for (const std::unique_ptr<ECSCommandBuffer>& commandBuffer : m_playbackCommandBuffers) {
+			for (const ECSCommandBuffer::Command& command : commandBuffer->getCommands()) {
+				Entity entity = command.entity;
+				if (getEntityGeneration(entity) == NTSHENGN_ENTITY_GENERATION_DEFERRED) {
+					// Deferred Entities created by another ECSCommandBuffer, or NTSHENGN_ENTITY_UNKNOWN, are skipped
+					if (getEntityIndex(entity) >= commandBuffer->getCreatedEntityCount()) {
+						continue;
+					}
+					entity = createdEntities[createdEntityOffset + getEntityIndex(entity)];
+				}
+
+				if (command.type == ECSCommandBuffer::CommandType::DestroyEntity) {
+					if (entityExists(entity) && destroyedEntitySet.insert(entity)) {
+						destroyedEntities.push_back(entity);
+					}
+				}
+				else {
+					pendingCommands.push_back({ entity, order++, &command });
+				}
+			}
+			createdEntityOffset += commandBuffer->getCreatedEntityCount();
+		}
+
+		// Commands are applied Entity by Entity, keeping the recording order for each Entity
+		std::sort(pendingCommands.begin(), pendingCommands.end(), [](const PendingCommand& a, const PendingCommand& b) {
+			const uint32_t aIndex = getEntityIndex(a.entity);
+			const uint32_t bIndex = getEntityIndex(b.entity);
+
+			return (aIndex < bIndex) || ((aIndex == bIndex) && (a.order < b.order));
+		});
+
+		// Commands on Entities destroyed during this playback are skipped
+		for (const PendingCommand& pendingCommand : pendingCommands) {
+			if (entityExists(pendingCommand.entity) && !destroyedEntitySet.contains(pendingCommand.entity)) {
+				pendingCommand.command->apply(*this, pendingCommand.entity, pendingCommand.command->component);
+			}
+		}
+
+		if (!destroyedEntities.empty()) {
+			destroyEntities(destroyedEntities);
+		}
+
+		for (std::unique_ptr<ECSCommandBuffer>& commandBuffer : m_playbackCommandBuffers) {
+			commandBuffer->clear();
+		}
+	}
+
 }
\ No newline at end of file
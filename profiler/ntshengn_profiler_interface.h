@@ -2,6 +2,7 @@
 #include "../utils/ntshengn_defines.h"
 #include <vector>
 #include <string>
+#include <map>
 
 namespace NtshEngn {
 
@@ -47,6 +48,10 @@ namespace NtshEngn {
 
 		virtual void startBlock(const std::string& blockName) = 0;
 		virtual void endBlock() = 0;
+
+		// Counters keep the last value set during the session (memory usage, object counts...)
+		virtual void setCounter(const std::string& counterName, double value) = 0;
+		virtual std::map<std::string, double> getCounters() = 0;
 	};
 
 }
\ No newline at end of file
@@ -220,7 +220,7 @@ namespace NtshEngn {
 		}
 
 		// ECS
-		Entity createEntity(const std::string& name = "") {
+		Entity createEntity(std::string_view name = "") {
 			if (!name.empty()) {
 				return ecs->createEntity(name);
 			}
@@ -228,10 +228,19 @@ namespace NtshEngn {
 			return ecs->createEntity();
 		}
 
+		template <typename... Components>
+		std::vector<Entity> createEntities(uint32_t count, const Components&... components) {
+			return ecs->createEntities(count, components...);
+		}
+
 		void destroyEntity(Entity entity) {
 			ecs->destroyEntity(entity);
 		}
 
+		void destroyEntities(const std::vector<Entity>& entities) {
+			ecs->destroyEntities(entities);
+		}
+
 		void destroyAllEntities() {
 			ecs->destroyAllEntities();
 		}
@@ -244,26 +253,38 @@ namespace NtshEngn {
 			return ecs->entityExists(entity);
 		}
 
-		const std::set<Entity>& getEntities() {
+		const EntitySet& getEntities() {
 			return ecs->getEntities();
 		}
 
-		void setEntityName(Entity entity, const std::string& name) {
-			ecs->setEntityName(entity, name);
+		ECSStatistics getECSStatistics() {
+			return ecs->getStatistics();
+		}
+
+		bool setEntityName(Entity entity, std::string_view name) {
+			return ecs->setEntityName(entity, name);
 		}
 
 		bool entityHasName(Entity entity) {
 			return ecs->entityHasName(entity);
 		}
 
-		std::string getEntityName(Entity entity) {
+		const std::string& getEntityName(Entity entity) {
 			return ecs->getEntityName(entity);
 		}
 
-		Entity findEntityByName(const std::string& name) {
+		Entity findEntityByName(std::string_view name) {
 			return ecs->findEntityByName(name);
 		}
 
+		NameID getEntityNameID(Entity entity) {
+			return ecs->getEntityNameID(entity);
+		}
+
+		Entity findEntityByNameID(NameID nameID) {
+			return ecs->findEntityByNameID(nameID);
+		}
+
 		void setEntityPersistence(Entity entity, bool persistent) {
 			return ecs->setEntityPersistence(entity, persistent);
 		}
@@ -272,33 +293,62 @@ namespace NtshEngn {
 			return ecs->isEntityPersistent(entity);
 		}
 
-		void addEntityToEntityGroup(Entity entity, const std::string& entityGroupName) {
+		void addEntityToEntityGroup(Entity entity, std::string_view entityGroupName) {
 			ecs->addEntityToEntityGroup(entity, entityGroupName);
 		}
 
-		void removeEntityFromEntityGroup(Entity entity, const std::string& entityGroupName) {
+		void removeEntityFromEntityGroup(Entity entity, std::string_view entityGroupName) {
 			ecs->removeEntityFromEntityGroup(entity, entityGroupName);
 		}
 
-		bool entityGroupExists(const std::string& entityGroupName) {
+		bool entityGroupExists(std::string_view entityGroupName) {
 			return ecs->entityGroupExists(entityGroupName);
 		}
 
-		bool isEntityInEntityGroup(Entity entity, const std::string& entityGroupName) {
+		bool isEntityInEntityGroup(Entity entity, std::string_view entityGroupName) {
 			return ecs->isEntityInEntityGroup(entity, entityGroupName);
 		}
 
-		std::set<Entity> getEntitiesInEntityGroup(const std::string& entityGroupName) {
+		bool isEntityInEntityGroup(Entity entity, EntityGroupID entityGroupID) {
+			return ecs->isEntityInEntityGroup(entity, entityGroupID);
+		}
+
+		const EntitySet& getEntitiesInEntityGroup(std::string_view entityGroupName) {
 			return ecs->getEntitiesInEntityGroup(entityGroupName);
 		}
 
-		std::set<std::string> getEntityGroupsOfEntity(Entity entity) {
+		const EntitySet& getEntitiesInEntityGroup(EntityGroupID entityGroupID) {
+			return ecs->getEntitiesInEntityGroup(entityGroupID);
+		}
+
+		const std::vector<EntityGroupID>& getEntityGroupsOfEntity(Entity entity) {
 			return ecs->getEntityGroupsOfEntity(entity);
 		}
 
+		EntityGroupID getEntityGroupID(std::string_view entityGroupName) {
+			return ecs->getEntityGroupID(entityGroupName);
+		}
+
+		const std::string& getEntityGroupName(EntityGroupID entityGroupID) {
+			return ecs->getEntityGroupName(entityGroupID);
+		}
+
+		EntitySet getEntityGroupsIntersection(EntityGroupID firstEntityGroupID, EntityGroupID secondEntityGroupID) {
+			return ecs->getEntityGroupsIntersection(firstEntityGroupID, secondEntityGroupID);
+		}
+
+		EntitySet getEntityGroupsUnion(EntityGroupID firstEntityGroupID, EntityGroupID secondEntityGroupID) {
+			return ecs->getEntityGroupsUnion(firstEntityGroupID, secondEntityGroupID);
+		}
+
 		template <typename T>
 		void addEntityComponent(Entity entity, T component) {
-			ecs->addComponent(entity, component);
+			ecs->addComponent(entity, std::move(component));
+		}
+
+		template <typename T, typename... Args>
+		T& emplaceEntityComponent(Entity entity, Args&&... args) {
+			return ecs->emplaceComponent<T>(entity, std::forward<Args>(args)...);
 		}
 
 		template <typename T>
@@ -316,6 +366,21 @@ namespace NtshEngn {
 			return ecs->getComponent<T>(entity);
 		}
 
+		template <typename T>
+		const T& readEntityComponent(Entity entity) {
+			return ecs->readComponent<T>(entity);
+		}
+
+		template <typename... Components, typename Function>
+		void forEachEntityComponents(Function&& function) {
+			ecs->forEach<Components...>(std::forward<Function>(function));
+		}
+
+		template <typename... Components, typename Function>
+		void parallelForEachEntityComponents(uint32_t grainSize, Function&& function) {
+			ecs->parallelForEach<Components...>(jobSystem, grainSize, std::forward<Function>(function));
+		}
+
 		// Input
 		InputState getKeyState(InputKeyboardKey key, WindowID windowID = NTSHENGN_WINDOW_UNKNOWN) {
 			if (!windowModule) {
@@ -1238,6 +1303,8 @@ namespace NtshEngn {
 		}
 
 		void waitAllThreads() {
+			NTSHENGN_ASSERT(!runningECSJob(), "waitAllThreads cannot be called from a System run concurrently by runSystems, it would wait for its own job.");
+
 			jobSystem->wait();
 		}
 
@@ -1292,6 +1359,18 @@ namespace NtshEngn {
 		void endProfilingBlock() {
 			profiler->endBlock();
 		}
+
+		void setProfilingCounter(const std::string& profilingCounterName, double value) {
+			profiler->setCounter(profilingCounterName, value);
+		}
+
+		std::map<std::string, double> getProfilingCounters() {
+			return profiler->getCounters();
+		}
+
+		void profileECSStatistics() {
+			ecs->exportStatistics(profiler);
+		}
 	
 	public:
 		void setEntityID(Entity passEntityID) { entityID = passEntityID; }
@@ -1,11 +1,27 @@
 #pragma once
 #include "ntshengn_defines.h"
+#include "ntshengn_utils_buffer.h"
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <vector>
-#include <forward_list>
-#include <unordered_map>
-#include <variant>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <charconv>
+#if defined(NTSHENGN_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NTSHENGN_JSON_SSE2
+#include <emmintrin.h>
+#endif
 
 #define NTSHENGN_JSON_INFO(message) \
 	do { \
@@ -23,6 +39,17 @@
 		exit(1); \
 	} while(0)
 
+// Can be defined before including this header
+#ifndef NTSHENGN_JSON_ARENA_BLOCK_SIZE
+#define NTSHENGN_JSON_ARENA_BLOCK_SIZE 65536
+#endif
+#ifndef NTSHENGN_JSON_STREAM_BUFFER_SIZE
+#define NTSHENGN_JSON_STREAM_BUFFER_SIZE 65536
+#endif
+#ifndef NTSHENGN_JSON_WRITER_BUFFER_SIZE
+#define NTSHENGN_JSON_WRITER_BUFFER_SIZE 65536
+#endif
+
 namespace NtshEngn {
 
 	class JSON {
@@ -36,79 +63,131 @@ namespace NtshEngn {
 			Null
 		};
 
-		class Node {
+		class Node;
+
+	private:
+		struct KeyNodePair {
+			std::string_view key;
+			Node* node;
+		};
+
+		// Blocks of memory holding the sources, Nodes, children and strings of a JSON document, only freed with it
+		class Arena {
 		public:
-			// Construct JSON::Type::Object
-			Node(const std::unordered_map<std::string, Node*> children) : m_type(Type::Object), m_value(children) {}
+			Arena() = default;
+			Arena(const Arena&) = delete;
+			Arena& operator=(const Arena&) = delete;
+			Arena(Arena&&) = default;
+			Arena& operator=(Arena&&) = default;
 
-			// Construct JSON::Type::Number
-			Node(float number) : m_type(Type::Number), m_value(number) {}
+			void* allocate(size_t size, size_t alignment) {
+				NTSHENGN_ASSERT(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Alignment is too large for the JSON arena.");
+
+				// Large allocations (sources) get their own block so that the current block keeps being filled
+				if (size > NTSHENGN_JSON_ARENA_BLOCK_SIZE) {
+					m_largeBlocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[size]));
+
+					return m_largeBlocks.back().get();
+				}
+
+				m_blockOffset = ((m_blockOffset + alignment - 1) / alignment) * alignment;
+				if (m_blocks.empty() || ((m_blockOffset + size) > NTSHENGN_JSON_ARENA_BLOCK_SIZE)) {
+					m_blocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[NTSHENGN_JSON_ARENA_BLOCK_SIZE]));
+					m_blockOffset = 0;
+				}
+
+				void* data = m_blocks.back().get() + m_blockOffset;
+				m_blockOffset += size;
+
+				return data;
+			}
+
+			// Objects in the arena are never destructed
+			template <typename T>
+			T* create(const T& object) {
+				static_assert(std::is_trivially_destructible_v<T>, "JSON arena objects must be trivially destructible.");
+
+				return new (allocate(sizeof(T), alignof(T))) T(object);
+			}
+
+			std::string_view storeString(std::string_view string) {
+				if (string.empty()) {
+					return std::string_view();
+				}
+
+				char* data = static_cast<char*>(allocate(string.size(), 1));
+				std::copy(string.begin(), string.end(), data);
 
-			// Construct JSON::Type::String
-			Node(const std::string& string) : m_type(Type::String), m_value(string) {}
+				return std::string_view(data, string.size());
+			}
+
+		private:
+			std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+			std::vector<std::unique_ptr<std::byte[]>> m_largeBlocks;
+			size_t m_blockOffset = 0;
+		};
 
-			// Construct JSON::Type::Array
-			Node(const std::vector<Node*>& array) : m_type(Type::Array), m_value(array) {}
+	public:
+		// Objects are flat arrays of key and Node pairs, in insertion order and searched linearly
+		// Strings and keys point into the parsed source or into the arena of the JSON document
+		// Nodes are created by parsing or with JSON::create*, they live as long as their JSON document
+		// Nodes built with the public constructors can only hold numbers, booleans and null, adding children or setting a string to them is an error
+		class Node {
+		public:
+			// Construct JSON::Type::Number
+			Node(float number) : m_type(Type::Number), m_number(number) {}
 
 			// Construct JSON::Type::Boolean
-			Node(bool boolean) : m_type(Type::Boolean), m_value(boolean) {}
+			Node(bool boolean) : m_type(Type::Boolean), m_boolean(boolean) {}
 
 			// Construct JSON::Type::Null
-			Node() : m_type(Type::Null), m_value() {}
+			Node() : m_type(Type::Null) {}
+
+			// Strings are created with JSON::createString
+			Node(const char* string) = delete;
 
 			Type getType() const {
 				return m_type;
 			}
 
-			bool contains(const std::string& childName) const {
+			bool contains(std::string_view childName) const {
 				NTSHENGN_ASSERT(m_type == Type::Object, "JSON Node has a wrong type (should be Object).");
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-
-				return (val.find(childName) != val.end());
+				return findChild(childName) != nullptr;
 			}
 
 			size_t size() const {
 				NTSHENGN_ASSERT((m_type == Type::Object) || (m_type == Type::Array), "JSON Node has a wrong type (should be Array).");
 
-				size_t size = 0;
-				if (m_type == Type::Object) {
-					size = std::get<std::unordered_map<std::string, Node*>>(m_value).size();
-				}
-				else if (m_type == Type::Array) {
-					size = std::get<std::vector<Node*>>(m_value).size();
-				}
-
-				return size;
+				return m_size;
 			}
 
 			// Access JSON::Type::Object
-			Node& operator[](const std::string& childName) {
+			Node& operator[](std::string_view childName) {
 				NTSHENGN_ASSERT(m_type == Type::Object, "JSON Node has a wrong type (should be Object).");
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) != val.end(), "Element \"" + childName + "\" in JSON Object Node does not exist.");
+				Node* child = findChild(childName);
+				NTSHENGN_ASSERT(child != nullptr, "Element \"" + std::string(childName) + "\" in JSON Object Node does not exist.");
 
-				return *val.at(childName);
+				return *child;
 			}
 
-			const Node& operator[](const std::string& childName) const {
+			const Node& operator[](std::string_view childName) const {
 				NTSHENGN_ASSERT(m_type == Type::Object, "JSON Node has a wrong type (should be Object).");
 
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) != val.end(), "Element \"" + childName + "\" in JSON Object Node does not exist.");
+				const Node* child = findChild(childName);
+				NTSHENGN_ASSERT(child != nullptr, "Element \"" + std::string(childName) + "\" in JSON Object Node does not exist.");
 
-				return *val.at(childName);
+				return *child;
 			}
 
 			const std::vector<std::string> getKeys() const {
 				NTSHENGN_ASSERT(m_type == Type::Object, "JSON Node has a wrong type (should be Object).");
 
 				std::vector<std::string> keys;
-
-				const std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				for (const auto& keyNodePair : val) {
-					keys.push_back(keyNodePair.first);
+				keys.reserve(m_size);
+				for (uint32_t i = 0; i < m_size; i++) {
+					keys.emplace_back(m_keyNodePairs[i].key);
 				}
 
 				return keys;
@@ -118,51 +197,54 @@ namespace NtshEngn {
 			float getNumber() const {
 				NTSHENGN_ASSERT(m_type == Type::Number, "JSON Node has a wrong type (should be Number).");
 
-				return std::get<float>(m_value);
+				return m_number;
 			}
 
 			// Access JSON::Type::String
 			std::string getString() const {
+				return std::string(getStringView());
+			}
+
+			std::string_view getStringView() const {
 				NTSHENGN_ASSERT(m_type == Type::String, "JSON Node has a wrong type (should be String).");
 
-				return std::get<std::string>(m_value);
+				return std::string_view(m_string, m_size);
 			}
 
 			// Access JSON::Type::Array
 			Node& operator[](const size_t element) {
 				NTSHENGN_ASSERT(m_type == Type::Array, "JSON Node has a wrong type (should be Array).");
+				NTSHENGN_ASSERT(element < m_size, "Index " + std::to_string(element) + " in JSON Array Node is superior than the size of the Array (" + std::to_string(m_size) + ").");
 
-				const std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
-				NTSHENGN_ASSERT(element < val.size(), "Index " + std::to_string(element) + " in JSON Array Node is superior than the size of the Array (" + std::to_string(val.size()) + ").");
-
-				return *val.at(element);
+				return *m_arrayElements[element];
 			}
 
 			const Node& operator[](const size_t element) const {
 				NTSHENGN_ASSERT(m_type == Type::Array, "JSON Node has a wrong type (should be Object or Array).");
+				NTSHENGN_ASSERT(element < m_size, "Index " + std::to_string(element) + " in JSON Array Node is superior than the size of the Array (" + std::to_string(m_size) + ").");
 
-				const std::vector<Node*>& val = std::get<std::vector<Node*>>(m_value);
-				NTSHENGN_ASSERT(element < val.size(), "Index " + std::to_string(element) + " in JSON Array Node is superior than the size of the Array (" + std::to_string(val.size()) + ").");
-
-				return *val.at(element);
+				return *m_arrayElements[element];
 			}
 
 			// Access JSON::Type::Boolean
 			bool getBoolean() const {
 				NTSHENGN_ASSERT(m_type == Type::Boolean, "JSON Node has a wrong type (should be Boolean).");
 
-				return std::get<bool>(m_value);
+				return m_boolean;
 			}
 
-			// Add object to JSON::Type::Object
-			void addObject(const std::string& childName, Node* childNode) {
+			// Add object to JSON::Type::Object, the key is copied in the arena
+			void addObject(std::string_view childName, Node* childNode) {
 				NTSHENGN_ASSERT((m_type == Type::Object) || (m_type == Type::Null), "JSON Node has a wrong type (should be Object or Null).");
+				checkArena();
+				NTSHENGN_ASSERT((m_type == Type::Null) || (findChild(childName) == nullptr), "Element \"" + std::string(childName) + "\" in JSON Object Node already exists.");
 
-				std::unordered_map<std::string, Node*>& val = std::get<std::unordered_map<std::string, Node*>>(m_value);
-				NTSHENGN_ASSERT(val.find(childName) == val.end(), "Element \"" + childName + "\" in JSON Object Node already exists.");
-
-				m_type = Type::Object;
-				val[childName] = childNode;
+				if (m_type == Type::Null) {
+					m_type = Type::Object;
+					m_keyNodePairs = nullptr;
+				}
+				reserveChildren(m_keyNodePairs);
+				m_keyNodePairs[m_size++] = { m_arena->storeString(childName), childNode };
 			}
 
 			// Set number to JSON::Type::Number
@@ -170,23 +252,30 @@ namespace NtshEngn {
 				NTSHENGN_ASSERT((m_type == Type::Number) || (m_type == Type::Null), "JSON Node has a wrong type (should be Number or Null).");
 
 				m_type = Type::Number;
-				std::get<float>(m_value) = number;
+				m_number = number;
 			}
 
-			// Set string to JSON::Type::String
-			void setString(const std::string& string) {
+			// Set string to JSON::Type::String, the string is copied in the arena
+			void setString(std::string_view string) {
 				NTSHENGN_ASSERT((m_type == Type::String) || (m_type == Type::Null), "JSON Node has a wrong type (should be String or Null).");
+				checkArena();
 
 				m_type = Type::String;
-				std::get<std::string>(m_value) = string;
+				m_string = m_arena->storeString(string).data();
+				m_size = static_cast<uint32_t>(string.size());
 			}
 
 			// Add object to JSON::Type::Array
 			void addObject(Node* element) {
 				NTSHENGN_ASSERT((m_type == Type::Array) || (m_type == Type::Null), "JSON Node has a wrong type (should be Array or Null).");
+				checkArena();
 
-				m_type = Type::Array;
-				std::get<std::vector<Node*>>(m_value).push_back(element);
+				if (m_type == Type::Null) {
+					m_type = Type::Array;
+					m_arrayElements = nullptr;
+				}
+				reserveChildren(m_arrayElements);
+				m_arrayElements[m_size++] = element;
 			}
 
 			// Set boolean to JSON::Type::Boolean
@@ -194,12 +283,312 @@ namespace NtshEngn {
 				NTSHENGN_ASSERT((m_type == Type::Boolean) || (m_type == Type::Null), "JSON Node has a wrong type (should be Boolean or Null).");
 				
 				m_type = Type::Boolean;
-				std::get<bool>(m_value) = boolean;
+				m_boolean = boolean;
+			}
+
+		private:
+			friend class JSON;
+
+			Node(Type type, Arena* arena) : m_type(type), m_arena(arena) {}
+
+			// Nodes built with the public constructors have no arena and cannot store children or strings, in any build type
+			void checkArena() const {
+				if (m_arena == nullptr) {
+					NTSHENGN_JSON_ERROR("JSON Node has not been created by a JSON document, use JSON::create* to create Nodes that can be modified.");
+				}
+			}
+
+			Node* findChild(std::string_view childName) const {
+				for (uint32_t i = 0; i < m_size; i++) {
+					if (m_keyNodePairs[i].key == childName) {
+						return m_keyNodePairs[i].node;
+					}
+				}
+
+				return nullptr;
+			}
+
+			// Children grow like a std::vector, the previous children stay unused in the arena
+			template <typename T>
+			void reserveChildren(T*& children) {
+				if (m_size == m_capacity) {
+					m_capacity = std::max<uint32_t>(4, m_capacity * 2);
+					T* newChildren = static_cast<T*>(m_arena->allocate(sizeof(T) * m_capacity, alignof(T)));
+					std::copy(children, children + m_size, newChildren);
+					children = newChildren;
+				}
 			}
 
 		private:
 			Type m_type;
-			std::variant<std::unordered_map<std::string, Node*>, float, std::string, std::vector<Node*>, bool> m_value;
+			uint32_t m_size = 0; // String length or number of children
+			uint32_t m_capacity = 0;
+			union {
+				float m_number = 0.0f;
+				bool m_boolean;
+			};
+			union {
+				const char* m_string = nullptr;
+				KeyNodePair* m_keyNodePairs;
+				Node** m_arrayElements;
+			};
+			Arena* m_arena = nullptr; // nullptr if the Node has not been created by a JSON document
+		};
+
+		// Receives the values of a JSON document in order, without building Nodes
+		// Keys and strings are only valid during the call
+		class Handler {
+		public:
+			virtual ~Handler() = default;
+
+			virtual void onObjectStart() {}
+			virtual void onKey(std::string_view key) { NTSHENGN_UNUSED(key); }
+			virtual void onObjectEnd() {}
+
+			virtual void onArrayStart() {}
+			virtual void onArrayEnd() {}
+
+			virtual void onNumber(float number) { NTSHENGN_UNUSED(number); }
+			virtual void onString(std::string_view string) { NTSHENGN_UNUSED(string); }
+			virtual void onBoolean(bool boolean) { NTSHENGN_UNUSED(boolean); }
+			virtual void onNull() {}
+		};
+
+		// Writes JSON text in a reusable string, or streams it to a file
+		// A Writer is a Handler, so that a streamed document can be written back without building Nodes
+		class Writer : public Handler {
+		public:
+			// Compact text has no whitespace, otherwise values are indented with tabs
+			Writer(bool compact = false) : m_compact(compact) {}
+			~Writer() {
+				close();
+			}
+
+			// The text is written to the file each time NTSHENGN_JSON_WRITER_BUFFER_SIZE bytes are reached
+			void open(const std::string& filePath) {
+				close();
+
+				m_file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!m_file.is_open()) {
+					NTSHENGN_JSON_ERROR("Cannot open JSON file \"" + filePath + "\".");
+				}
+			}
+
+			void close() {
+				if (m_file.is_open()) {
+					flush();
+					m_file.close();
+				}
+			}
+
+			// Keeps the capacity of the string for the next document
+			void clear() {
+				m_string.clear();
+				m_emptyContainers.clear();
+				m_afterKey = false;
+			}
+
+			const std::string& getString() const {
+				return m_string;
+			}
+
+			void write(const Node& node) {
+				switch (node.m_type) {
+				case Type::Object: {
+					onObjectStart();
+					for (uint32_t i = 0; i < node.m_size; i++) {
+						onKey(node.m_keyNodePairs[i].key);
+						write(*node.m_keyNodePairs[i].node);
+					}
+					onObjectEnd();
+					break;
+				}
+
+				case Type::Number: {
+					onNumber(node.m_number);
+					break;
+				}
+
+				case Type::String: {
+					onString(std::string_view(node.m_string, node.m_size));
+					break;
+				}
+
+				case Type::Array: {
+					onArrayStart();
+					for (uint32_t i = 0; i < node.m_size; i++) {
+						write(*node.m_arrayElements[i]);
+					}
+					onArrayEnd();
+					break;
+				}
+
+				case Type::Boolean: {
+					onBoolean(node.m_boolean);
+					break;
+				}
+
+				case Type::Null: {
+					onNull();
+					break;
+				}
+
+				default:
+					break;
+				}
+			}
+
+			void onObjectStart() override {
+				startValue();
+				m_string += '{';
+				m_emptyContainers.push_back(true);
+			}
+
+			void onKey(std::string_view key) override {
+				NTSHENGN_ASSERT(!m_emptyContainers.empty() && !m_afterKey, "JSON key is not in an Object.");
+
+				startValue();
+				writeString(key);
+				m_string += m_compact ? ":" : ": ";
+				m_afterKey = true;
+			}
+
+			void onObjectEnd() override {
+				endContainer('}');
+			}
+
+			void onArrayStart() override {
+				startValue();
+				m_string += '[';
+				m_emptyContainers.push_back(true);
+			}
+
+			void onArrayEnd() override {
+				endContainer(']');
+			}
+
+			// Numbers use the shortest representation that reads back to the same float, JSON has no infinity nor NaN so they are written as null
+			void onNumber(float number) override {
+				startValue();
+				if (!std::isfinite(number)) {
+					m_string += "null";
+
+					return;
+				}
+
+				char numberCharacters[32];
+#if defined(__cpp_lib_to_chars)
+				const std::to_chars_result result = std::to_chars(numberCharacters, numberCharacters + sizeof(numberCharacters), number);
+				m_string.append(numberCharacters, result.ptr);
+#else
+				const int numberSize = std::snprintf(numberCharacters, sizeof(numberCharacters), "%.9g", static_cast<double>(number));
+				m_string.append(numberCharacters, static_cast<size_t>(numberSize));
+#endif
+			}
+
+			void onString(std::string_view string) override {
+				startValue();
+				writeString(string);
+			}
+
+			void onBoolean(bool boolean) override {
+				startValue();
+				m_string += boolean ? "true" : "false";
+			}
+
+			void onNull() override {
+				startValue();
+				m_string += "null";
+			}
+
+		private:
+			// Separates the value from the previous one in its container
+			void startValue() {
+				flushIfFull();
+
+				if (m_afterKey) {
+					m_afterKey = false;
+
+					return;
+				}
+
+				if (!m_emptyContainers.empty()) {
+					if (!m_emptyContainers.back()) {
+						m_string += ',';
+					}
+					m_emptyContainers.back() = false;
+					if (!m_compact) {
+						m_string += '\n';
+						m_string.append(m_emptyContainers.size(), '\t');
+					}
+				}
+			}
+
+			void endContainer(char closingBracket) {
+				NTSHENGN_ASSERT(!m_emptyContainers.empty() && !m_afterKey, "JSON Object or Array end does not match a start.");
+
+				const bool emptyContainer = m_emptyContainers.back();
+				m_emptyContainers.pop_back();
+				if (!emptyContainer && !m_compact) {
+					m_string += '\n';
+					m_string.append(m_emptyContainers.size(), '\t');
+				}
+				m_string += closingBracket;
+				flushIfFull();
+			}
+
+			// Copies the runs of characters that do not need to be escaped
+			void writeString(std::string_view string) {
+				static const char hexadecimalDigits[] = "0123456789abcdef";
+
+				m_string += '"';
+				const char* runStart = string.data();
+				const char* stringEnd = string.data() + string.size();
+				for (const char* position = string.data(); position != stringEnd; position++) {
+					const unsigned char c = static_cast<unsigned char>(*position);
+					if ((c >= 0x20) && (c != '"') && (c != '\\')) {
+						continue;
+					}
+
+					m_string.append(runStart, position);
+					switch (c) {
+					case '"': m_string += "\\\""; break;
+					case '\\': m_string += "\\\\"; break;
+					case '\b': m_string += "\\b"; break;
+					case '\f': m_string += "\\f"; break;
+					case '\n': m_string += "\\n"; break;
+					case '\r': m_string += "\\r"; break;
+					case '\t': m_string += "\\t"; break;
+					default:
+						m_string += "\\u00";
+						m_string += hexadecimalDigits[c >> 4];
+						m_string += hexadecimalDigits[c & 0xF];
+					}
+					runStart = position + 1;
+				}
+				m_string.append(runStart, stringEnd);
+				m_string += '"';
+			}
+
+			void flushIfFull() {
+				if (m_file.is_open() && (m_string.size() >= NTSHENGN_JSON_WRITER_BUFFER_SIZE)) {
+					flush();
+				}
+			}
+
+			void flush() {
+				m_file.write(m_string.data(), static_cast<std::streamsize>(m_string.size()));
+				m_string.clear();
+			}
+
+		private:
+			bool m_compact;
+
+			std::string m_string;
+			std::ofstream m_file;
+
+			std::vector<bool> m_emptyContainers; // Objects and Arrays being written, true while they have no value
+			bool m_afterKey = false;
 		};
 
 	private:
@@ -219,246 +608,389 @@ namespace NtshEngn {
 
 		struct Token {
 			TokenType type;
-			std::string value = "";
+			std::string_view value = ""; // Points into the source, or into the Lexer until the next token if escaped
+			bool escaped = false;
 		};
 
+		// Tokenizes a source in memory, or a file streamed through a buffer, scanning it with a pointer
 		class Lexer {
 		public:
-			~Lexer() {
+			void open(std::string_view source) {
 				if (m_file.is_open()) {
 					m_file.close();
 				}
+
+				m_current = source.data();
+				m_end = source.data() + source.size();
+				m_streamEnded = true;
+				m_endOfFile = false;
 			}
 
+			// The file is read NTSHENGN_JSON_STREAM_BUFFER_SIZE bytes at a time, the buffer only grows for longer tokens
 			void open(const std::string& filePath) {
-				m_file.open(filePath, std::fstream::in | std::fstream::binary);
+				if (m_file.is_open()) {
+					m_file.close();
+				}
+
+				m_file.open(filePath, std::ios::in | std::ios::binary);
 				if (!m_file.is_open()) {
 					NTSHENGN_JSON_ERROR("Cannot open JSON file \"" + filePath + "\".");
 				}
+
+				m_buffer.resize(NTSHENGN_JSON_STREAM_BUFFER_SIZE + 1);
+				m_current = m_buffer.data();
+				m_end = m_buffer.data();
+				m_streamEnded = false;
+				m_endOfFile = false;
 			}
 
-			char nextCharacter() {
-				char c = ' ';
-				while ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t')) {
-					m_file.get(c);
+			Token getNextToken() {
+				Token token;
 
-					if (((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t')) && m_file.eof()) {
-						return '\0';
-					}
+				if (m_endOfFile) {
+					NTSHENGN_JSON_ERROR("Reached end-of-file early.");
 				}
 
-				return c;
-			}
+				while (true) {
+					skipWhitespaces();
+					if (m_current == m_end) {
+						if (refill()) {
+							continue;
+						}
 
-			Token getNextToken() {
-				Token token;
+						token.type = TokenType::EndOfFile;
+						m_endOfFile = true;
 
-				char c;
+						return token;
+					}
 
-				if (m_file.eof()) {
-					NTSHENGN_JSON_ERROR("Reached end-of-file early.");
+					// A token cut by the end of the buffer is scanned again after the refill
+					if (scanToken(token)) {
+						return token;
+					}
+					refill();
 				}
+			}
 
-				m_previousPosition = m_file.tellg();
-				c = nextCharacter();
+			bool endOfFile() {
+				return m_endOfFile;
+			}
+
+		private:
+			// Returns false, without moving, if the token is cut by the end of the buffer and the file has more to read
+			bool scanToken(Token& token) {
+				const char c = *m_current;
 				if (c == '"') {
 					token.type = TokenType::String;
-					token.value = "";
 
-					m_file.get(c);
-					while (c != '\"') {
-						token.value += c;
-
-						m_file.get(c);
-					}
+					return scanString(token);
 				}
 				else if (c == '{') {
 					token.type = TokenType::CurlyBracketOpen;
+					m_current++;
 				}
 				else if (c == '}') {
 					token.type = TokenType::CurlyBracketClose;
+					m_current++;
 				}
 				else if (c == '[') {
 					token.type = TokenType::ArrayBracketOpen;
+					m_current++;
 				}
 				else if (c == ']') {
 					token.type = TokenType::ArrayBracketClose;
+					m_current++;
 				}
 				else if (c == ':') {
 					token.type = TokenType::Colon;
+					m_current++;
 				}
 				else if (c == ',') {
 					token.type = TokenType::Comma;
+					m_current++;
 				}
-				else if (c == '-' || ((c >= '0') && (c <= '9'))) {
+				else if ((c == '-') || ((c >= '0') && (c <= '9'))) {
 					token.type = TokenType::Number;
-					token.value += c;
 
-					size_t previousCharPosition;
-					while ((c == '-') || (c == '.') || (c == 'e') || ((c >= '0') && (c <= '9'))) {
-						previousCharPosition = m_file.tellg();
-						m_file.get(c);
-
-						if (m_file.eof()) {
-							break;
-						}
-
-						if ((c == '-') || (c == '.') || (c == 'e') || ((c >= '0') && (c <= '9'))) {
-							token.value += c;
-						}
-						else {
-							m_file.seekg(previousCharPosition);
-							break;
-						}
+					const char* numberEnd = m_current;
+					while ((numberEnd != m_end) && isNumberCharacter(*numberEnd)) {
+						numberEnd++;
+					}
+					if ((numberEnd == m_end) && !m_streamEnded) {
+						return false;
 					}
+					token.value = std::string_view(m_current, static_cast<size_t>(numberEnd - m_current));
+					m_current = numberEnd;
 				}
 				else if (c == 't') {
 					token.type = TokenType::Boolean;
-					token.value = "t";
 
-					m_file.get(c);
-					token.value += c;
+					return scanLiteral(token, "true");
+				}
+				else if (c == 'f') {
+					token.type = TokenType::Boolean;
 
-					if (c == 'r') {
-						m_file.get(c);
-						token.value += c;
+					return scanLiteral(token, "false");
+				}
+				else if (c == 'n') {
+					token.type = TokenType::Null;
 
-						if (c == 'u') {
-							m_file.get(c);
-							token.value += c;
+					return scanLiteral(token, "null");
+				}
+				else {
+					NTSHENGN_JSON_ERROR("Reached an unknown token (\"" + std::string() + c + "\").");
+				}
 
-							if (c != 'e') {
-								NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
-							}
-						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
-						}
-					}
-					else {
-						NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
-					}
+				return true;
+			}
+
+			// Keeps the unread part of the buffer, returns false if nothing more could be read
+			bool refill() {
+				if (m_streamEnded) {
+					return false;
 				}
-				else if (c == 'f') {
-					token.type = TokenType::Boolean;
-					token.value = "f";
 
-					m_file.get(c);
-					token.value += c;
+				const size_t keptSize = static_cast<size_t>(m_end - m_current);
+				std::memmove(m_buffer.data(), m_current, keptSize);
+				if (keptSize == (m_buffer.size() - 1)) {
+					m_buffer.resize((m_buffer.size() - 1) * 2 + 1);
+				}
 
-					if (c == 'a') {
-						m_file.get(c);
-						token.value += c;
+				m_file.read(m_buffer.data() + keptSize, static_cast<std::streamsize>(m_buffer.size() - 1 - keptSize));
+				const size_t readSize = static_cast<size_t>(m_file.gcount());
+				m_buffer[keptSize + readSize] = '\0';
+				m_current = m_buffer.data();
+				m_end = m_buffer.data() + keptSize + readSize;
+				m_streamEnded = m_file.eof() || (readSize == 0);
 
-						if (c == 'l') {
-							m_file.get(c);
-							token.value += c;
+				return readSize != 0;
+			}
 
-							if (c == 's') {
-								m_file.get(c);
-								token.value += c;
+			static bool isWhitespace(char c) {
+				return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+			}
 
-								if (c != 'e') {
-									NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
-								}
-							}
-							else {
-								NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
-							}
-						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
+			static bool isNumberCharacter(char c) {
+				return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E');
+			}
+
+			static uint32_t countTrailingZeros(uint32_t mask) {
+#if defined(NTSHENGN_COMPILER_MSVC)
+				unsigned long index;
+				_BitScanForward(&index, mask);
+
+				return static_cast<uint32_t>(index);
+#elif defined(NTSHENGN_COMPILER_GCC) || defined(NTSHENGN_COMPILER_CLANG)
+				return static_cast<uint32_t>(__builtin_ctz(mask));
+#else
+				uint32_t index = 0;
+				while ((mask & 1) == 0) {
+					mask >>= 1;
+					index++;
+				}
+
+				return index;
+#endif
+			}
+
+			// Indentation makes long whitespace runs, which are skipped 16 characters at a time
+			void skipWhitespaces() {
+				while ((m_current != m_end) && isWhitespace(*m_current)) {
+					m_current++;
+#if defined(NTSHENGN_JSON_SSE2)
+					while ((m_end - m_current) >= 16) {
+						const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_current));
+						const __m128i whitespaces = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(characters, _mm_set1_epi8('\n'))), _mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(characters, _mm_set1_epi8('\t'))));
+						const uint32_t nonWhitespaceMask = static_cast<uint32_t>(~_mm_movemask_epi8(whitespaces)) & 0xFFFF;
+						if (nonWhitespaceMask != 0) {
+							m_current += countTrailingZeros(nonWhitespaceMask);
+
+							return;
 						}
+						m_current += 16;
 					}
-					else {
-						NTSHENGN_JSON_ERROR("\"" + token.value + "\" token is invalid.");
+#endif
+				}
+			}
+
+			// Returns the first quote or backslash from position, or m_end
+			const char* findStringSpecialCharacter(const char* position) const {
+#if defined(NTSHENGN_JSON_SSE2)
+				while ((m_end - position) >= 16) {
+					const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+					const uint32_t specialCharacterMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8('"')), _mm_cmpeq_epi8(characters, _mm_set1_epi8('\\')))));
+					if (specialCharacterMask != 0) {
+						return position + countTrailingZeros(specialCharacterMask);
 					}
+					position += 16;
+				}
+#endif
+				while ((position != m_end) && (*position != '"') && (*position != '\\')) {
+					position++;
 				}
-				else if (c == 'n') {
-					token.type = TokenType::Null;
-					std::string nullValue = "n";
 
-					m_file.get(c);
-					nullValue += c;
-					if (c == 'u') {
-						m_file.get(c);
-						nullValue += c;
+				return position;
+			}
 
-						if (c == 'l') {
-							m_file.get(c);
-							nullValue += c;
+			// Strings without escape sequences are returned in place, the other ones are unescaped in m_unescapedString
+			bool scanString(Token& token) {
+				const char* stringStart = m_current + 1;
+				const char* position = findStringSpecialCharacter(stringStart);
+				const bool hasEscapeSequences = (position != m_end) && (*position == '\\');
+				while ((position != m_end) && (*position == '\\')) {
+					position = ((m_end - position) > 2) ? findStringSpecialCharacter(position + 2) : m_end;
+				}
 
-							if (c != 'l') {
-								NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.");
-							}
-						}
-						else {
-							NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.");
-						}
+				if (position == m_end) {
+					if (!m_streamEnded) {
+						return false;
 					}
-					else {
-						NTSHENGN_JSON_ERROR("\"" + nullValue + "\" token is invalid.");
+
+					NTSHENGN_JSON_ERROR("Reached end-of-file while parsing a string.");
+				}
+
+				if (!hasEscapeSequences) {
+					token.value = std::string_view(stringStart, static_cast<size_t>(position - stringStart));
+				}
+				else {
+					unescapeString(stringStart, position);
+					token.value = m_unescapedString;
+					token.escaped = true;
+				}
+				m_current = position + 1;
+
+				return true;
+			}
+
+			void unescapeString(const char* position, const char* stringEnd) {
+				m_unescapedString.clear();
+				while (position != stringEnd) {
+					const char* backslash = std::find(position, stringEnd, '\\');
+					m_unescapedString.append(position, backslash);
+					if (backslash == stringEnd) {
+						break;
+					}
+
+					// The closing quote search guarantees that a character follows the backslash
+					position = backslash + 1;
+					switch (*position) {
+					case '"': m_unescapedString += '"'; break;
+					case '\\': m_unescapedString += '\\'; break;
+					case '/': m_unescapedString += '/'; break;
+					case 'b': m_unescapedString += '\b'; break;
+					case 'f': m_unescapedString += '\f'; break;
+					case 'n': m_unescapedString += '\n'; break;
+					case 'r': m_unescapedString += '\r'; break;
+					case 't': m_unescapedString += '\t'; break;
+					case 'u': position = unescapeCodePoint(position + 1, stringEnd) - 1; break;
+					default:
+						NTSHENGN_JSON_ERROR("\"\\" + std::string() + *position + "\" escape sequence is invalid.");
+					}
+					position++;
+				}
+			}
+
+			// Appends the code point of the four hexadecimal digits at position (and its low surrogate) as UTF-8, returns the position after them
+			const char* unescapeCodePoint(const char* position, const char* stringEnd) {
+				uint32_t codePoint = readHexadecimalDigits(position, stringEnd);
+				position += 4;
+				if ((codePoint >= 0xD800) && (codePoint <= 0xDBFF) && ((stringEnd - position) >= 6) && (position[0] == '\\') && (position[1] == 'u')) {
+					const uint32_t lowSurrogate = readHexadecimalDigits(position + 2, stringEnd);
+					if ((lowSurrogate >= 0xDC00) && (lowSurrogate <= 0xDFFF)) {
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+						position += 6;
 					}
 				}
-				else if (c == '\0') {
-					token.type = TokenType::EndOfFile;
+
+				if (codePoint < 0x80) {
+					m_unescapedString += static_cast<char>(codePoint);
+				}
+				else if (codePoint < 0x800) {
+					m_unescapedString += static_cast<char>(0xC0 | (codePoint >> 6));
+					m_unescapedString += static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+				else if (codePoint < 0x10000) {
+					m_unescapedString += static_cast<char>(0xE0 | (codePoint >> 12));
+					m_unescapedString += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					m_unescapedString += static_cast<char>(0x80 | (codePoint & 0x3F));
 				}
 				else {
-					NTSHENGN_JSON_ERROR("Reached an unknown token (\"" + std::string() + c + "\").");
+					m_unescapedString += static_cast<char>(0xF0 | (codePoint >> 18));
+					m_unescapedString += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+					m_unescapedString += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					m_unescapedString += static_cast<char>(0x80 | (codePoint & 0x3F));
 				}
 
-				return token;
+				return position;
 			}
 
-			bool endOfFile() {
-				return m_file.eof();
+			static uint32_t readHexadecimalDigits(const char* position, const char* stringEnd) {
+				if ((stringEnd - position) < 4) {
+					NTSHENGN_JSON_ERROR("\"\\u" + std::string(position, stringEnd) + "\" escape sequence is invalid.");
+				}
+
+				uint32_t value = 0;
+				for (size_t i = 0; i < 4; i++) {
+					const char c = position[i];
+					value <<= 4;
+					if ((c >= '0') && (c <= '9')) {
+						value |= static_cast<uint32_t>(c - '0');
+					}
+					else if ((c >= 'a') && (c <= 'f')) {
+						value |= static_cast<uint32_t>(c - 'a' + 10);
+					}
+					else if ((c >= 'A') && (c <= 'F')) {
+						value |= static_cast<uint32_t>(c - 'A' + 10);
+					}
+					else {
+						NTSHENGN_JSON_ERROR("\"\\u" + std::string(position, 4) + "\" escape sequence is invalid.");
+					}
+				}
+
+				return value;
+			}
+
+			bool scanLiteral(Token& token, std::string_view literal) {
+				const size_t remainingSize = static_cast<size_t>(m_end - m_current);
+				if ((remainingSize < literal.size()) && !m_streamEnded) {
+					return false;
+				}
+
+				if ((remainingSize < literal.size()) || (std::string_view(m_current, literal.size()) != literal)) {
+					NTSHENGN_JSON_ERROR("\"" + std::string(m_current, std::min(remainingSize, literal.size())) + "\" token is invalid.");
+				}
+				token.value = literal;
+				m_current += literal.size();
+
+				return true;
 			}
 
 		private:
-			std::fstream m_file;
-			size_t m_previousPosition;
+			const char* m_current = nullptr;
+			const char* m_end = nullptr;
+			bool m_endOfFile = true;
+
+			// Streamed file
+			std::ifstream m_file;
+			std::vector<char> m_buffer;
+			bool m_streamEnded = true;
+
+			std::string m_unescapedString;
 		};
 
 		class Parser {
 		public:
-			Node parse(const std::string& filePath) {
-				m_lexer.open(filePath);
-				
+			// The source must outlive the Nodes
+			Node parse(std::string_view source, Arena& arena) {
+				m_lexer.open(source);
+				m_arena = &arena;
+
 				Node root;
 				bool rootInitialized = false;
 
 				while (!m_lexer.endOfFile()) {
 					Token token = m_lexer.getNextToken();
-					Node node;
-					switch (token.type) {
-					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
-						break;
-					}
-
-					case TokenType::String: {
-						node = Node(token.value);
-						break;
-					}
-
-					case TokenType::Number: {
-						node = Node(std::stof(token.value));
-						break;
-					}
-
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
-						break;
-					}
-
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
-						break;
-					}
-
-					default:
-						break;
-					}
+					Node node = parseValue(token);
 
 					if (!rootInitialized) {
 						root = node;
@@ -471,8 +1003,46 @@ namespace NtshEngn {
 			}
 
 		private:
+			Node parseValue(const Token& token) {
+				switch (token.type) {
+				case TokenType::CurlyBracketOpen:
+					return parseObject();
+
+				case TokenType::String: {
+					Node node(Type::String, m_arena);
+					const std::string_view string = storeTokenValue(token);
+					node.m_string = string.data();
+					node.m_size = static_cast<uint32_t>(string.size());
+
+					return node;
+				}
+
+				case TokenType::Number: {
+					Node node(Type::Number, m_arena);
+					node.m_number = toNumber(token.value);
+
+					return node;
+				}
+
+				case TokenType::ArrayBracketOpen:
+					return parseArray();
+
+				case TokenType::Boolean: {
+					Node node(Type::Boolean, m_arena);
+					node.m_boolean = (token.value == "true");
+
+					return node;
+				}
+
+				default:
+					return Node(Type::Null, m_arena);
+				}
+			}
+
+			// The children are gathered on m_keyNodePairs, then copied in the arena once their number is known
 			Node parseObject() {
-				Node objectNode = Node(std::unordered_map<std::string, Node*>());
+				Node objectNode(Type::Object, m_arena);
+				const size_t firstKeyNodePair = m_keyNodePairs.size();
 
 				bool endOfObject = false;
 				while (!endOfObject) {
@@ -481,52 +1051,21 @@ namespace NtshEngn {
 
 					// Empty object
 					if (keyToken.type == TokenType::CurlyBracketClose) {
-						return objectNode;
+						break;
 					}
+					const std::string_view key = storeTokenValue(keyToken);
 
 					// Colon
 					if (m_lexer.getNextToken().type != TokenType::Colon) {
-						NTSHENGN_JSON_ERROR("An object key (\"" + keyToken.value + "\") is not followed by a colon.");
+						NTSHENGN_JSON_ERROR("An object key (\"" + std::string(key) + "\") is not followed by a colon.");
 					}
 
 					Token token = m_lexer.getNextToken();
-					Node node;
-					switch (token.type) {
-					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
-						break;
-					}
-
-					case TokenType::String: {
-						node = Node(token.value);
-						break;
-					}
-
-					case TokenType::Number: {
-						node = Node(std::stof(token.value));
-						break;
-					}
-
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
-						break;
-					}
-
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
-						break;
-					}
-
-					case TokenType::EndOfFile: {
+					if (token.type == TokenType::EndOfFile) {
 						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an object.");
 					}
-
-					default:
-						break;
-					}
-
-					m_nodes.push_front(node);
-					objectNode.addObject(keyToken.value, &m_nodes.front());
+					Node* node = m_arena->create(parseValue(token));
+					m_keyNodePairs.push_back({ key, node });
 
 					// Next token is either a comma or a curly bracket close
 					if (m_lexer.getNextToken().type == TokenType::CurlyBracketClose) {
@@ -534,11 +1073,18 @@ namespace NtshEngn {
 					}
 				}
 
+				objectNode.m_size = static_cast<uint32_t>(m_keyNodePairs.size() - firstKeyNodePair);
+				objectNode.m_capacity = objectNode.m_size;
+				objectNode.m_keyNodePairs = static_cast<KeyNodePair*>(m_arena->allocate(sizeof(KeyNodePair) * objectNode.m_size, alignof(KeyNodePair)));
+				std::copy(m_keyNodePairs.begin() + firstKeyNodePair, m_keyNodePairs.end(), objectNode.m_keyNodePairs);
+				m_keyNodePairs.resize(firstKeyNodePair);
+
 				return objectNode;
 			}
 
 			Node parseArray() {
-				Node arrayNode = Node(std::vector<Node*>());
+				Node arrayNode(Type::Array, m_arena);
+				const size_t firstArrayElement = m_arrayElements.size();
 
 				bool endOfArray = false;
 				while (!endOfArray) {
@@ -546,128 +1092,299 @@ namespace NtshEngn {
 
 					// Empty array
 					if (token.type == TokenType::ArrayBracketClose) {
-						return arrayNode;
+						break;
+					}
+
+					if (token.type == TokenType::EndOfFile) {
+						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an array.");
+					}
+					Node* node = m_arena->create(parseValue(token));
+					m_arrayElements.push_back(node);
+
+					// Next token is either a comma or an array bracket close
+					if (m_lexer.getNextToken().type == TokenType::ArrayBracketClose) {
+						endOfArray = true;
 					}
+				}
+
+				arrayNode.m_size = static_cast<uint32_t>(m_arrayElements.size() - firstArrayElement);
+				arrayNode.m_capacity = arrayNode.m_size;
+				arrayNode.m_arrayElements = static_cast<Node**>(m_arena->allocate(sizeof(Node*) * arrayNode.m_size, alignof(Node*)));
+				std::copy(m_arrayElements.begin() + firstArrayElement, m_arrayElements.end(), arrayNode.m_arrayElements);
+				m_arrayElements.resize(firstArrayElement);
+
+				return arrayNode;
+			}
+
+			// Unescaped values only live until the next token and are copied in the arena
+			std::string_view storeTokenValue(const Token& token) {
+				return token.escaped ? m_arena->storeString(token.value) : token.value;
+			}
+
+		private:
+			Lexer m_lexer;
+			Arena* m_arena = nullptr;
+
+			// Children of the Objects and Arrays being parsed
+			std::vector<KeyNodePair> m_keyNodePairs;
+			std::vector<Node*> m_arrayElements;
+		};
 
-					Node node;
+		// Walks the tokens without recursion, only the nesting of the Objects and Arrays being read is kept
+		class Reader {
+		public:
+			void readFile(const std::string& filePath, Handler& handler) {
+				m_lexer.open(filePath);
+				read(handler);
+			}
+
+			void readSource(std::string_view source, Handler& handler) {
+				m_lexer.open(source);
+				read(handler);
+			}
+
+		private:
+			void read(Handler& handler) {
+				m_containers.clear();
+
+				Token token = m_lexer.getNextToken();
+				if (token.type == TokenType::EndOfFile) {
+					return;
+				}
+
+				while (true) {
+					// token starts a value
 					switch (token.type) {
 					case TokenType::CurlyBracketOpen: {
-						node = parseObject();
-						break;
+						handler.onObjectStart();
+						token = m_lexer.getNextToken();
+						if (token.type == TokenType::CurlyBracketClose) {
+							handler.onObjectEnd();
+							break;
+						}
+
+						m_containers.push_back(TokenType::CurlyBracketOpen);
+						readKey(token, handler);
+						token = m_lexer.getNextToken();
+						continue;
+					}
+
+					case TokenType::ArrayBracketOpen: {
+						handler.onArrayStart();
+						token = m_lexer.getNextToken();
+						if (token.type == TokenType::ArrayBracketClose) {
+							handler.onArrayEnd();
+							break;
+						}
+
+						m_containers.push_back(TokenType::ArrayBracketOpen);
+						continue;
 					}
 
 					case TokenType::String: {
-						node = Node(token.value);
+						handler.onString(token.value);
 						break;
 					}
 
 					case TokenType::Number: {
-						node = Node(std::stof(token.value));
+						handler.onNumber(toNumber(token.value));
 						break;
 					}
 
-					case TokenType::ArrayBracketOpen: {
-						node = parseArray();
+					case TokenType::Boolean: {
+						handler.onBoolean(token.value == "true");
 						break;
 					}
 
-					case TokenType::Boolean: {
-						node = Node(token.value == "true");
+					case TokenType::Null: {
+						handler.onNull();
 						break;
 					}
 
 					case TokenType::EndOfFile: {
-						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing an array.");
+						NTSHENGN_JSON_ERROR("Reached end-of-file while parsing " + std::string((m_containers.back() == TokenType::CurlyBracketOpen) ? "an object" : "an array") + ".");
 					}
 
 					default:
-						break;
+						NTSHENGN_JSON_ERROR("Reached an unexpected token while parsing a value.");
 					}
 
-					m_nodes.push_front(node);
-					arrayNode.addObject(&m_nodes.front());
+					// The value is complete, the next token either separates it from the next value or closes its container
+					while (true) {
+						if (m_containers.empty()) {
+							return;
+						}
 
-					// Next token is either a comma or an array bracket close
-					if (m_lexer.getNextToken().type == TokenType::ArrayBracketClose) {
-						endOfArray = true;
+						token = m_lexer.getNextToken();
+						if (token.type == TokenType::Comma) {
+							token = m_lexer.getNextToken();
+							if (m_containers.back() == TokenType::CurlyBracketOpen) {
+								readKey(token, handler);
+								token = m_lexer.getNextToken();
+							}
+							break;
+						}
+						else if ((token.type == TokenType::CurlyBracketClose) && (m_containers.back() == TokenType::CurlyBracketOpen)) {
+							m_containers.pop_back();
+							handler.onObjectEnd();
+						}
+						else if ((token.type == TokenType::ArrayBracketClose) && (m_containers.back() == TokenType::ArrayBracketOpen)) {
+							m_containers.pop_back();
+							handler.onArrayEnd();
+						}
+						else {
+							NTSHENGN_JSON_ERROR("Reached an unexpected token after a value in " + std::string((m_containers.back() == TokenType::CurlyBracketOpen) ? "an object" : "an array") + ".");
+						}
 					}
 				}
+			}
 
-				return arrayNode;
+			void readKey(const Token& keyToken, Handler& handler) {
+				if (keyToken.type != TokenType::String) {
+					NTSHENGN_JSON_ERROR("An object key is not a string.");
+				}
+				handler.onKey(keyToken.value);
+
+				// Colon
+				if (m_lexer.getNextToken().type != TokenType::Colon) {
+					NTSHENGN_JSON_ERROR("An object key is not followed by a colon.");
+				}
 			}
 
 		private:
 			Lexer m_lexer;
-			
-			std::forward_list<Node> m_nodes;
+
+			std::vector<TokenType> m_containers; // CurlyBracketOpen or ArrayBracketOpen
 		};
 
 	public:
+		// Nodes point to the arena of their JSON document, which is kept on the heap so that moving the document does not invalidate them
+		// Copying a JSON document is not supported, as its Nodes would still point into the original one
+		JSON() = default;
+		JSON(const JSON&) = delete;
+		JSON& operator=(const JSON&) = delete;
+		JSON(JSON&&) = default;
+		JSON& operator=(JSON&&) = default;
+
 		Node read(const std::string& filePath) {
-			return m_parser.parse(filePath);
+			std::ifstream file(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+			if (!file.is_open()) {
+				NTSHENGN_JSON_ERROR("Cannot open JSON file \"" + filePath + "\".");
+			}
+
+			// The source is kept in the arena as strings and keys point into it
+			const size_t sourceSize = static_cast<size_t>(file.tellg());
+			char* source = static_cast<char*>(getArena().allocate(sourceSize, 1));
+			file.seekg(0);
+			file.read(source, static_cast<std::streamsize>(sourceSize));
+
+			return m_parser.parse(std::string_view(source, sourceSize), getArena());
 		}
 
-	public:
-		static std::string to_string(const Node& node) {
-			return to_string(node, 0, false);
+		// Streams the file to the handler, memory usage does not depend on the size of the file
+		void read(const std::string& filePath, Handler& handler) {
+			m_reader.readFile(filePath, handler);
 		}
 
-	private:
-		static std::string to_string(const Node& node, size_t indentationLevel, bool indentFirst) {
-			const std::string indentation = std::string(indentationLevel, '\t');
-			std::string jsonString = (indentFirst ? indentation : "");
+		// The source is copied in the arena, as strings and keys point into it
+		Node parse(std::string_view source) {
+			char* storedSource = static_cast<char*>(getArena().allocate(source.size(), 1));
+			std::copy(source.begin(), source.end(), storedSource);
 
-			switch (node.getType()) {
-			case Type::Object: {
-				jsonString += "{\n";
-				std::vector<std::string> keys = node.getKeys();
-				for (const std::string& key : keys) {
-					jsonString += indentation + "\t\"" + key + "\": " + to_string(node[key], indentationLevel + 1, false);
-					jsonString += (key != keys.back()) ? ",\n" : "\n";
-				}
-				jsonString += indentation + "}";
-				break;
-			}
+			return m_parser.parse(std::string_view(storedSource, source.size()), getArena());
+		}
 
-			case Type::Number: {
-				jsonString += std::to_string(node.getNumber());
-				break;
-			}
+		Node parse(const Buffer& buffer) {
+			return parse(std::string_view(reinterpret_cast<const char*>(buffer.getData()), buffer.getSize()));
+		}
 
-			case Type::String: {
-				jsonString += "\"" + node.getString() + "\"";
-				break;
-			}
+		// The source is not copied
+		void parse(std::string_view source, Handler& handler) {
+			m_reader.readSource(source, handler);
+		}
 
-			case Type::Array: {
-				jsonString += "[\n";
-				for (size_t i = 0; i < node.size(); i++) {
-					jsonString += to_string(node[i], indentationLevel + 1, true);
-					jsonString += (i < (node.size() - 1)) ? ",\n" : "\n";
-				}
-				jsonString += indentation + "]";
-				break;
-			}
+		void parse(const Buffer& buffer, Handler& handler) {
+			parse(std::string_view(reinterpret_cast<const char*>(buffer.getData()), buffer.getSize()), handler);
+		}
 
-			case Type::Boolean: {
-				jsonString += node.getBoolean() ? "true" : "false";
-				break;
-			}
+		// Created Nodes live as long as the JSON document
+		Node* createObject() {
+			return getArena().create(Node(Type::Object, &getArena()));
+		}
+
+		Node* createNumber(float number) {
+			Node* node = getArena().create(Node(Type::Number, &getArena()));
+			node->m_number = number;
+
+			return node;
+		}
+
+		Node* createString(std::string_view string) {
+			Node* node = getArena().create(Node(Type::String, &getArena()));
+			node->m_string = getArena().storeString(string).data();
+			node->m_size = static_cast<uint32_t>(string.size());
+
+			return node;
+		}
+
+		Node* createArray() {
+			return getArena().create(Node(Type::Array, &getArena()));
+		}
+
+		Node* createBoolean(bool boolean) {
+			Node* node = getArena().create(Node(Type::Boolean, &getArena()));
+			node->m_boolean = boolean;
 
-			case Type::Null: {
-				jsonString += "null";
-				break;
+			return node;
+		}
+
+		Node* createNull() {
+			return getArena().create(Node(Type::Null, &getArena()));
+		}
+
+	public:
+		static std::string to_string(const Node& node, bool compact = false) {
+			Writer writer(compact);
+			writer.write(node);
+
+			return writer.getString();
+		}
+
+		// Streams the text to the file instead of building it in memory
+		static void write(const std::string& filePath, const Node& node, bool compact = false) {
+			Writer writer(compact);
+			writer.open(filePath);
+			writer.write(node);
+			writer.close();
+		}
+
+	private:
+		// Number tokens are not null-terminated in the source
+		static float toNumber(std::string_view numberToken) {
+			char number[64];
+			if (numberToken.size() < sizeof(number)) {
+				std::copy(numberToken.begin(), numberToken.end(), number);
+				number[numberToken.size()] = '\0';
+
+				return std::strtof(number, nullptr);
 			}
 
-			default:
-				break;
+			return std::strtof(std::string(numberToken).c_str(), nullptr);
+		}
+
+		// A moved-from JSON document gets a new arena when it is used again
+		Arena& getArena() {
+			if (!m_arena) {
+				m_arena = std::make_unique<Arena>();
 			}
 
-			return jsonString;
+			return *m_arena;
 		}
 
 	private:
+		std::unique_ptr<Arena> m_arena;
 		Parser m_parser;
+		Reader m_reader;
 	};
 
 }
\ No newline at end of file